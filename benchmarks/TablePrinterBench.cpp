@@ -0,0 +1,629 @@
+//
+// Throughput benchmark for TablePrinter.
+//
+// Usage: TablePrinterBench [rows] [output file]
+//
+// Each scenario prints the given number of rows (default 200000) into a sink that discards everything,
+// into a file (default TablePrinterBench.out in the working directory), and into the same file through an
+// AsyncSink and (on POSIX systems) through a FileDescriptorSink. The results are reported as rows per second,
+// megabytes per second and heap allocations per row.
+//
+// TablePrinterBenchStats is built with TABLEPRINTER_ENABLE_STATISTICS, to measure the cost of collecting
+// statistics; it ends by printing the statistics of the report table itself.
+//
+
+#include <TablePrinter.hpp>
+
+#ifdef TABLEPRINTER_HAS_FD_SINK
+#include <fcntl.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <utility>
+#include <string>
+#include <thread>
+#include <vector>
+
+//======================================================================================================================
+// Allocation counting
+//======================================================================================================================
+
+namespace
+{
+    std::atomic<std::uint64_t> allocationCount{0};
+}
+
+// Every form of operator new is replaced, and forwards to malloc (or aligned_alloc), so that every form of
+// operator delete can forward to free. Release is kept out of line, as GCC otherwise sees free() inlined next to
+// a new-expression and warns about a mismatched deallocation.
+
+namespace
+{
+    void* CountedAllocate(std::size_t size) noexcept {
+
+        ++allocationCount;
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    void* CountedAllocate(std::size_t size, std::align_val_t alignment) noexcept {
+
+        ++allocationCount;
+        auto align = static_cast<std::size_t>(alignment);
+        size       = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+        return std::aligned_alloc(align, size);
+    }
+
+    [[gnu::noinline]] void Release(void* ptr) noexcept {
+
+        std::free(ptr);
+    }
+} // namespace
+
+void* operator new(std::size_t size) {
+
+    if (auto* ptr = CountedAllocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+
+    if (auto* ptr = CountedAllocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+
+    if (auto* ptr = CountedAllocate(size, alignment)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+
+    if (auto* ptr = CountedAllocate(size, alignment)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+
+    return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+
+    return CountedAllocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+
+    return CountedAllocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+
+    return CountedAllocate(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { Release(ptr); }
+void operator delete[](void* ptr) noexcept { Release(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { Release(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { Release(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { Release(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { Release(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { Release(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { Release(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { Release(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { Release(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { Release(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { Release(ptr); }
+
+namespace
+{
+    //==================================================================================================================
+    // Sinks
+    //==================================================================================================================
+
+    /**
+     * @brief A stream buffer that discards everything written to it.
+     */
+    class NullBuffer : public std::streambuf {
+    protected:
+        int_type overflow(int_type ch) override {
+
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(const char*, std::streamsize count) override {
+
+            return count;
+        }
+    };
+
+    //==================================================================================================================
+    // Input data
+    //==================================================================================================================
+
+    /**
+     * @brief Pre-generated cell data, so that the benchmark does not measure the creation of the input.
+     */
+    struct Data {
+
+        explicit Data(std::size_t count) {
+
+            for (std::size_t i = 0; i < count; ++i) {
+                shortStrings.emplace_back("Name " + std::to_string(i % 1000));
+                longStrings.emplace_back("A rather long description that does not fit in its column, number " +
+                                         std::to_string(i));
+                integers.emplace_back(static_cast<long long>(i * 7919 % 1000003) - 500000);
+                doubles.emplace_back(static_cast<double>(integers.back()) / 97.0);
+            }
+
+            for (std::size_t i = 0; i < count; ++i)
+                records.push_back({shortStrings[i], integers[i] % 100, longStrings[i], doubles[i]});
+        }
+
+        struct Record {
+            std::string name;
+            long long   age;
+            std::string position;
+            double      allowance;
+        };
+
+        std::vector<std::string> shortStrings;
+        std::vector<std::string> longStrings;
+        std::vector<long long>   integers;
+        std::vector<double>      doubles;
+        std::vector<Record>      records;
+    };
+
+    /**
+     * @brief A minimal view of a slice of a vector, for feeding batches to PrintRows and PrintColumns.
+     */
+    template<typename T>
+    struct Slice {
+        const T*    first;
+        const T*    last;
+        const T*    begin() const { return first; }
+        const T*    end() const { return last; }
+        const T*    data() const { return first; }
+        std::size_t size() const { return static_cast<std::size_t>(last - first); }
+    };
+
+    //==================================================================================================================
+    // Measurement
+    //==================================================================================================================
+
+    struct Result {
+        std::size_t   rows{0};
+        double        seconds{0.0};
+        std::uint64_t bytes{0};
+        std::uint64_t allocations{0};
+    };
+
+    /**
+     * @brief Where a scenario prints to: a sink passing everything on to the destination sink, counting the bytes.
+     * @details Bytes are counted as they are handed over, so text still held by an AsyncSink or a FileDescriptorSink
+     * is included, without reading the position of a file another thread may be writing to. Every scenario
+     * flushes before it stops the clock, so by then all of the text has reached the destination.
+     */
+    class Output : public trl::Sink {
+    public:
+        explicit Output(trl::Sink& destination)
+                : m_destination(destination) {}
+
+        void Write(const char* data, std::size_t size) override {
+
+            m_bytes += size;
+            m_destination.Write(data, size);
+        }
+
+        void Flush() override {
+
+            m_destination.Flush();
+        }
+
+        std::uint64_t Bytes() const {
+
+            return m_bytes;
+        }
+
+    private:
+        trl::Sink&    m_destination;
+        std::uint64_t m_bytes{0};
+    };
+
+    /**
+     * @brief Print the header, warm up, and then time the printing of (at least) the given number of rows.
+     * @details printRow(tp, data, i) is called with an index into the data; it prints rowsPerCall rows.
+     */
+    template<typename Printer, typename PrintRow>
+    Result Measure(Printer&    tp,
+                   const Data& data,
+                   std::size_t rows,
+                   Output&     out,
+                   PrintRow    printRow,
+                   std::size_t rowsPerCall = 1) {
+
+        tp.PrintHeader();
+        auto count = (data.integers.size() - 32) / rowsPerCall;
+        auto calls = (rows + rowsPerCall - 1) / rowsPerCall;
+
+        // Warm up, so that buffers have reached their steady state size before measuring.
+        for (std::size_t i = 0; i < 100; ++i) printRow(tp, data, i % count);
+
+        auto startBytes       = out.Bytes();
+        auto startAllocations = allocationCount.load();
+        auto startTime        = std::chrono::steady_clock::now();
+
+        for (std::size_t i = 0; i < calls; ++i) printRow(tp, data, i % count);
+        tp.Flush();
+
+        auto endTime = std::chrono::steady_clock::now();
+
+        Result result;
+        result.rows        = calls * rowsPerCall;
+        result.seconds     = std::chrono::duration<double>(endTime - startTime).count();
+        result.allocations = allocationCount.load() - startAllocations;
+        result.bytes       = out.Bytes() - startBytes;
+
+        tp.PrintFooter();
+        return result;
+    }
+
+    //==================================================================================================================
+    // Scenarios
+    //==================================================================================================================
+
+    /**
+     * @brief A named benchmark, printing a number of rows of some table layout to a stream.
+     */
+    struct Scenario {
+        std::string                                                       name;
+        std::function<Result(const Data&, std::size_t, Output&)> run;
+    };
+
+    /**
+     * @brief Make a scenario for a TablePrinter, from a function setting up the columns and one printing a row.
+     */
+    template<typename Setup, typename PrintRow>
+    Scenario Dynamic(std::string name, Setup setup, PrintRow printRow) {
+
+        return {std::move(name), [=](const Data& data, std::size_t rows, Output& out) {
+                    trl::TablePrinter tp(out);
+                    setup(tp);
+                    return Measure(tp, data, rows, out, printRow);
+                }};
+    }
+
+    std::vector<Scenario> MakeScenarios() {
+
+        std::vector<Scenario> scenarios;
+
+        scenarios.push_back(Dynamic("Short strings",
+                             [](trl::TablePrinter& tp) {
+                                 for (int i = 0; i < 4; ++i) tp.AddColumn("Text " + std::to_string(i), 12);
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 tp << data.shortStrings[i] << data.shortStrings[i + 1] << data.shortStrings[i + 2]
+                                    << data.shortStrings[i + 3];
+                             }));
+
+        scenarios.push_back(Dynamic("Integers",
+                             [](trl::TablePrinter& tp) {
+                                 for (int i = 0; i < 4; ++i) tp.AddColumn("Int " + std::to_string(i), 10);
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 tp << data.integers[i] << data.integers[i + 1] << data.integers[i + 2]
+                                    << data.integers[i + 3];
+                             }));
+
+        scenarios.push_back(Dynamic("Doubles",
+                             [](trl::TablePrinter& tp) {
+                                 for (int i = 0; i < 4; ++i) tp.AddColumn("Double " + std::to_string(i), 10);
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 tp << data.doubles[i] << data.doubles[i + 1] << data.doubles[i + 2]
+                                    << data.doubles[i + 3];
+                             }));
+
+        scenarios.push_back(Dynamic("Doubles (formatted)",
+                             [](trl::TablePrinter& tp) {
+                                 tp.AddColumn("Money", 14, ",.2f");
+                                 tp.AddColumn("Scientific", 10, ".3e");
+                                 tp.AddColumn("SI", 8, ".1s");
+                                 tp.AddColumn("Bytes", 8, ".1i");
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 tp << data.doubles[i] << data.doubles[i + 1] << data.doubles[i + 2]
+                                    << data.doubles[i + 3];
+                             }));
+
+        scenarios.push_back({"Doubles (columnar)", [](const Data& data, std::size_t rows, Output& out) {
+                                 trl::TablePrinter tp(out);
+                                 for (int i = 0; i < 4; ++i) tp.AddColumn("Double " + std::to_string(i), 10);
+
+                                 constexpr std::size_t batch = 1024;
+                                 auto printBatch = [](trl::TablePrinter& printer, const Data& input, std::size_t i) {
+                                     const auto* first = input.doubles.data() + i * batch;
+                                     printer.PrintColumns(Slice<double>{first, first + batch},
+                                                     Slice<double>{first + 1, first + 1 + batch},
+                                                     Slice<double>{first + 2, first + 2 + batch},
+                                                     Slice<double>{first + 3, first + 3 + batch});
+                                 };
+                                 return Measure(tp, data, rows, out, printBatch, batch);
+                             }});
+
+        scenarios.push_back(Dynamic("Long strings",
+                             [](trl::TablePrinter& tp) {
+                                 tp.AddColumn("Id", 8);
+                                 tp.AddColumn("Description", 30);
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 tp << data.integers[i] << data.longStrings[i];
+                             }));
+
+        scenarios.push_back(Dynamic("Mixed",
+                             [](trl::TablePrinter& tp) {
+                                 tp.AddColumn("Name", 25);
+                                 tp.AddColumn("Age", 5);
+                                 tp.AddColumn("Position", 30);
+                                 tp.AddColumn("Allowance", 9);
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 tp << data.shortStrings[i] << data.integers[i] % 100 << data.longStrings[i]
+                                    << data.doubles[i];
+                             }));
+
+        scenarios.push_back(Dynamic("Mixed (CSV)",
+                             [](trl::TablePrinter& tp) {
+                                 tp.AddColumn("Name", 25);
+                                 tp.AddColumn("Age", 5);
+                                 tp.AddColumn("Position", 30);
+                                 tp.AddColumn("Allowance", 9);
+                                 tp.SetOutputFormat(trl::OutputFormat::Csv);
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 tp << data.shortStrings[i] << data.integers[i] % 100 << data.longStrings[i]
+                                    << data.doubles[i];
+                             }));
+
+        // A boxed table, and the same rows as CSV to a second (discarding) stream, whose bytes are not counted.
+        scenarios.push_back(Dynamic("Mixed (tee CSV)",
+                             [](trl::TablePrinter& tp) {
+                                 static NullBuffer   buffer;
+                                 static std::ostream csv(&buffer);
+                                 tp.AddColumn("Name", 25);
+                                 tp.AddColumn("Age", 5);
+                                 tp.AddColumn("Position", 30);
+                                 tp.AddColumn("Allowance", 9);
+                                 tp.AddOutput(csv, trl::OutputFormat::Csv);
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 tp << data.shortStrings[i] << data.integers[i] % 100 << data.longStrings[i]
+                                    << data.doubles[i];
+                             }));
+
+        scenarios.push_back(Dynamic("Mixed (auto width)",
+                             [](trl::TablePrinter& tp) {
+                                 tp.AddColumn("Name", 25);
+                                 tp.AddColumn("Age", 5);
+                                 tp.AddColumn("Position", 30);
+                                 tp.AddColumn("Allowance", 9);
+                                 tp.SetAutoWidth(1000);
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 tp << data.shortStrings[i] << data.integers[i] % 100 << data.longStrings[i]
+                                    << data.doubles[i];
+                             }));
+
+        scenarios.push_back(Dynamic("Mixed (buffered, MT)",
+                             [](trl::TablePrinter& tp) {
+                                 tp.AddColumn("Name", 25);
+                                 tp.AddColumn("Age", 5);
+                                 tp.AddColumn("Position", 30);
+                                 tp.AddColumn("Allowance", 9);
+                                 tp.SetAutoWidth();
+                                 tp.SetFormattingThreads();
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 tp << data.shortStrings[i] << data.integers[i] % 100 << data.longStrings[i]
+                                    << data.doubles[i];
+                             }));
+
+        scenarios.push_back(Dynamic("Mixed (sorted)",
+                             [](trl::TablePrinter& tp) {
+                                 tp.AddColumn("Name", 25);
+                                 tp.AddColumn("Age", 5);
+                                 tp.AddColumn("Position", 30);
+                                 tp.AddColumn("Allowance", 9);
+                                 tp.AddSortColumn(1);
+                                 tp.AddSortColumn(3, trl::SortOrder::Descending);
+                                 tp.SetFormattingThreads();
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 tp << data.shortStrings[i] << data.integers[i] % 100 << data.longStrings[i]
+                                    << data.doubles[i];
+                             }));
+
+        // Only the 50 rows with the largest allowance are printed; bytes and rows/s reflect the rows scanned.
+        scenarios.push_back(Dynamic("Mixed (top 50)",
+                             [](trl::TablePrinter& tp) {
+                                 tp.AddColumn("Name", 25);
+                                 tp.AddColumn("Age", 5);
+                                 tp.AddColumn("Position", 30);
+                                 tp.AddColumn("Allowance", 9);
+                                 tp.AddSortColumn(3, trl::SortOrder::Descending);
+                                 tp.SetTopRows(50);
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 tp << data.shortStrings[i] << data.integers[i] % 100 << data.longStrings[i]
+                                    << data.doubles[i];
+                             }));
+
+        scenarios.push_back({"Mixed (4 producers)", [](const Data& data, std::size_t rows, Output& out) {
+                                 trl::TablePrinter tp(out);
+                                 tp.AddColumn("Name", 25);
+                                 tp.AddColumn("Age", 5);
+                                 tp.AddColumn("Position", 30);
+                                 tp.AddColumn("Allowance", 9);
+                                 tp.PrintHeader();
+
+                                 constexpr std::size_t producerCount = 4;
+                                 auto                  count         = data.integers.size() - 32;
+                                 auto                  perProducer   = (rows + producerCount - 1) / producerCount;
+
+                                 auto startBytes       = out.Bytes();
+                                 auto startAllocations = allocationCount.load();
+                                 auto startTime        = std::chrono::steady_clock::now();
+                                 {
+                                     trl::ConcurrentTablePrinter ctp(tp);
+                                     std::vector<std::thread>    producers;
+                                     for (std::size_t p = 0; p < producerCount; ++p) {
+                                         producers.emplace_back([&, p] {
+                                             for (std::size_t n = 0; n < perProducer; ++n) {
+                                                 auto i = (p * perProducer + n) % count;
+                                                 ctp.Submit(data.shortStrings[i], data.integers[i] % 100, data.longStrings[i],
+                                                            data.doubles[i]);
+                                             }
+                                         });
+                                     }
+                                     for (auto& producer : producers) producer.join();
+                                 }
+                                 tp.Flush();
+                                 auto endTime = std::chrono::steady_clock::now();
+
+                                 Result result;
+                                 result.rows        = perProducer * producerCount;
+                                 result.seconds     = std::chrono::duration<double>(endTime - startTime).count();
+                                 result.allocations = allocationCount.load() - startAllocations;
+                                 result.bytes       = out.Bytes() - startBytes;
+
+                                 tp.PrintFooter();
+                                 return result;
+                             }});
+
+        scenarios.push_back({"Mixed (batch)", [](const Data& data, std::size_t rows, Output& out) {
+                                 trl::TablePrinter tp(out);
+                                 tp.AddColumn("Name", 25);
+                                 tp.AddColumn("Age", 5);
+                                 tp.AddColumn("Position", 30);
+                                 tp.AddColumn("Allowance", 9);
+
+                                 constexpr std::size_t batch = 1024;
+                                 auto printBatch = [](trl::TablePrinter& printer, const Data& input, std::size_t i) {
+                                     const auto* first = input.records.data() + i * batch;
+                                     printer.PrintRows(Slice<Data::Record>{first, first + batch},
+                                                  &Data::Record::name,
+                                                  &Data::Record::age,
+                                                  &Data::Record::position,
+                                                  &Data::Record::allowance);
+                                 };
+                                 return Measure(tp, data, rows, out, printBatch, batch);
+                             }});
+
+        scenarios.push_back(Dynamic("Many narrow columns",
+                             [](trl::TablePrinter& tp) {
+                                 for (int i = 0; i < 24; ++i) tp.AddColumn("C" + std::to_string(i), 5);
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 for (std::size_t c = 0; c < 24; ++c) tp << data.integers[i + c] % 10000;
+                             }));
+
+        scenarios.push_back(Dynamic("Few wide columns",
+                             [](trl::TablePrinter& tp) {
+                                 tp.AddColumn("Left", 60);
+                                 tp.AddColumn("Right", 60);
+                             },
+                             [](trl::TablePrinter& tp, const Data& data, std::size_t i) {
+                                 tp << data.shortStrings[i] << data.longStrings[i];
+                             }));
+
+        scenarios.push_back({"Mixed (static)", [](const Data& data, std::size_t rows, Output& out) {
+                                 trl::StaticTablePrinter<trl::Column<std::string, 25>,
+                                                         trl::Column<long long, 5>,
+                                                         trl::Column<std::string, 30>,
+                                                         trl::Column<double, 9>>
+                                     tp({"Name", "Age", "Position", "Allowance"}, out);
+                                 return Measure(tp, data, rows, out, [](auto& printer, const Data& input, std::size_t i) {
+                                     printer.PrintRow(input.shortStrings[i], input.integers[i] % 100, input.longStrings[i],
+                                                      input.doubles[i]);
+                                 });
+                             }});
+
+        return scenarios;
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+
+    std::size_t rows     = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    std::string fileName = argc > 2 ? argv[2] : "TablePrinterBench.out";
+    if (rows == 0) rows = 1;
+
+    Data data(4096);
+    auto scenarios = MakeScenarios();
+
+    trl::TablePrinter report;
+    report.AddColumn("Scenario", 20);
+    report.AddColumn("Sink", 5);
+    report.AddColumn("Rows/s", 12);
+    report.AddColumn("MB/s", 9);
+    report.AddColumn("Allocs/row", 10);
+    report.PrintTitle("TablePrinter throughput (" + std::to_string(rows) + " rows)");
+    report.PrintHeader();
+
+    auto print = [&](const Scenario& scenario, const char* sink, const Result& result) {
+        report << scenario.name << sink << static_cast<long long>(static_cast<double>(result.rows) / result.seconds)
+               << static_cast<double>(result.bytes) / result.seconds / 1.0e6
+               << static_cast<double>(result.allocations) / static_cast<double>(result.rows);
+    };
+
+    for (const auto& scenario : scenarios) {
+
+        {
+            NullBuffer      nullBuffer;
+            std::ostream    nullStream(&nullBuffer);
+            trl::StreamSink sink(nullStream);
+            Output          out(sink);
+            print(scenario, "null", scenario.run(data, rows, out));
+        }
+        {
+            std::ofstream   file(fileName, std::ios::binary | std::ios::trunc);
+            trl::StreamSink sink(file);
+            Output          out(sink);
+            print(scenario, "file", scenario.run(data, rows, out));
+        }
+        {
+            std::ofstream  file(fileName, std::ios::binary | std::ios::trunc);
+            trl::AsyncSink sink(file);
+            Output         out(sink);
+            print(scenario, "async", scenario.run(data, rows, out));
+        }
+#ifdef TABLEPRINTER_HAS_FD_SINK
+        {
+            int fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) continue;
+            {
+                trl::FileDescriptorSink sink(fd);
+                Output                  out(sink);
+                print(scenario, "fd", scenario.run(data, rows, out));
+            }
+            ::close(fd);
+        }
+#endif
+    }
+
+    report.PrintFooter();
+#ifdef TABLEPRINTER_ENABLE_STATISTICS
+    report.PrintStatistics(std::cout);
+#endif
+    std::remove(fileName.c_str());
+
+    return 0;
+}
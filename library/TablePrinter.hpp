@@ -32,330 +32,6019 @@
 
 #include "rang.hpp"
 
+#if defined(__unix__) || defined(__unix) || defined(__APPLE__)
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#include <system_error>
+#define TABLEPRINTER_HAS_FD_SINK
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TABLEPRINTER_HAS_SSE2
+#endif
+
 #include <iostream>
 #include <iomanip>
 #include <vector>
+#include <array>
+#include <string>
+#include <string_view>
 #include <sstream>
+#include <charconv>
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include <iterator>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <thread>
+#include <exception>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+// Define TABLEPRINTER_ENABLE_STATISTICS before including this header to have printers collect the statistics
+// reported by TablePrinter::GetStatistics. Collecting them reads the clock around every call and every write, which
+// is significant for narrow rows. Otherwise the instrumentation is compiled out, and costs nothing.
 
 namespace trl
 {
 
     /**
-     * @brief
+     * @brief What a printer has done and what it has cost; see TablePrinter::GetStatistics.
+     * @details Only collected when TABLEPRINTER_ENABLE_STATISTICS is defined; otherwise everything is zero.
      */
-    class endl
-    {
+    struct TableStatistics {
+
+        /**
+         * @brief The statistics of one column.
+         */
+        struct Column {
+            std::uint64_t cells{0}; /**< the number of cells printed */
+            std::uint64_t truncated{0}; /**< numbers cut to the column width, ending in the overflow marker */
+            std::uint64_t overflowed{0}; /**< cells wider than the column, pushing the rest of the row out of line */
+        };
+
+        std::uint64_t            rows{0}; /**< the number of rows printed, summary rows included */
+        std::uint64_t            bytes{0}; /**< the number of bytes written to the sinks */
+        std::uint64_t            writes{0}; /**< the number of writes to the sinks */
+        std::uint64_t            flushes{0}; /**< the number of sink flushes */
+        std::chrono::nanoseconds formattingTime{0}; /**< time spent in the printer, other than writing */
+        std::chrono::nanoseconds writingTime{0}; /**< time spent writing to the sinks */
+        std::vector<Column>      columns; /**< the statistics of each column */
     };
 
     /**
-     * @brief Print a pretty table into your output of choice.
-     *
-     * Usage:
-     *   TablePrinter tp(&std::cout);
-     *   tp.AddColumn("Name", 25);
-     *   tp.AddColumn("Age", 3);
-     *   tp.AddColumn("Position", 30);
-     *
-     *   tp.PrintHeader();
-     *   tp << "Dat Chu" << 25 << "Research Assistant";
-     *   tp << "John Doe" << 26 << "Professional Anonymity";
-     *   tp << "Jane Doe" << tp.SkipToNextLine();
-     *   tp << "Tom Doe" << 7 << "Student";
-     *   tp.PrintFooter();
-     *
-     * @todo Add support for padding in each table cell
-     **/
-    class TablePrinter {
-    public:
+     * @brief The text formats a table can be printed in; see TablePrinter::SetOutputFormat.
+     */
+    enum class OutputFormat {
+        Boxed, /**< a table with borders, padded to the column widths */
+        Csv, /**< comma separated values, quoted as in RFC 4180 */
+        Tsv, /**< tab separated values, with tabs, newlines and backslashes escaped by a backslash */
+        Markdown, /**< a GitHub flavored Markdown table */
+        JsonLines /**< one JSON object per row, keyed by the column titles */
+    };
 
+    namespace detail
+    {
         /**
-         * @brief
-         * @param output
-         * @param separator
+         * @brief Are statistics collected? All instrumentation is behind `if constexpr` on this flag.
          */
-        explicit TablePrinter(std::ostream& output = std::cout, const std::string& separator = "|")
-                : m_outStream(output),
-                  m_columnSeparator(separator) {
-
-        }
+#ifdef TABLEPRINTER_ENABLE_STATISTICS
+        constexpr bool StatisticsEnabled = true;
+#else
+        constexpr bool StatisticsEnabled = false;
+#endif
 
         /**
-         * @brief
+         * @brief A stream buffer that appends everything written to it to a std::string.
+         * @details Used for formatting arbitrary streamable cell values without allocating a new
+         * std::stringstream (and a new std::string) for every cell.
          */
-        TablePrinter(const TablePrinter& other) = delete;
+        class StringAppendBuffer : public std::streambuf {
+        public:
+
+            /**
+             * @brief Set the string that subsequent output is appended to.
+             * @param target The target string.
+             */
+            void SetTarget(std::string* target) {
+
+                m_target = target;
+            }
+
+        protected:
+
+            int_type overflow(int_type ch) override {
+
+                if (ch != traits_type::eof()) m_target->push_back(traits_type::to_char_type(ch));
+                return ch;
+            }
+
+            std::streamsize xsputn(const char* s, std::streamsize count) override {
+
+                m_target->append(s, static_cast<std::size_t>(count));
+                return count;
+            }
+
+        private:
+            std::string* m_target{nullptr}; /**< The string being appended to. */
+        };
 
         /**
-         * @brief
-         * @param other
+         * @brief Check whether a text is plain ASCII, 16 bytes at a time where SSE2 is available, and 8 bytes at a
+         * time otherwise.
          */
-        TablePrinter(TablePrinter&& other) = delete;
+        inline bool IsAscii(std::string_view text) {
+
+            const auto* data = text.data();
+            std::size_t size = text.size();
+            std::size_t i    = 0;
+
+#ifdef TABLEPRINTER_HAS_SSE2
+            for (; i + 16 <= size; i += 16) {
+                auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                if (_mm_movemask_epi8(block) != 0) return false;
+            }
+#endif
+            for (; i + 8 <= size; i += 8) {
+                std::uint64_t block;
+                std::memcpy(&block, data + i, sizeof(block));
+                if (block & 0x8080808080808080ull) return false;
+            }
+            for (; i < size; ++i)
+                if (static_cast<unsigned char>(data[i]) & 0x80) return false;
+            return true;
+        }
 
         /**
-         * @brief
+         * @brief A range of code points, for the display width tables.
          */
-        ~TablePrinter() = default;
+        struct CodePointRange {
+            char32_t first; /**< the first code point in the range */
+            char32_t last; /**< the last code point in the range */
+        };
 
         /**
-         * @brief
-         * @param other
-         * @return
+         * @brief Code points that take up no space: combining marks, zero width characters and format controls.
          */
-        TablePrinter& operator=(const TablePrinter& other) = delete;
+        constexpr CodePointRange ZeroWidthCodePoints[] = {
+            {0x0300, 0x036F},   {0x0483, 0x0489},   {0x0591, 0x05BD},   {0x05BF, 0x05BF},   {0x05C1, 0x05C2},
+            {0x05C4, 0x05C5},   {0x05C7, 0x05C7},   {0x0610, 0x061A},   {0x064B, 0x065F},   {0x0670, 0x0670},
+            {0x06D6, 0x06DC},   {0x06DF, 0x06E4},   {0x06E7, 0x06E8},   {0x06EA, 0x06ED},   {0x0711, 0x0711},
+            {0x0730, 0x074A},   {0x07A6, 0x07B0},   {0x07EB, 0x07F3},   {0x0901, 0x0902},   {0x093C, 0x093C},
+            {0x0941, 0x0948},   {0x094D, 0x094D},   {0x0951, 0x0954},   {0x0962, 0x0963},   {0x0981, 0x0981},
+            {0x09BC, 0x09BC},   {0x09C1, 0x09C4},   {0x09CD, 0x09CD},   {0x09E2, 0x09E3},   {0x0A01, 0x0A02},
+            {0x0A3C, 0x0A3C},   {0x0A41, 0x0A42},   {0x0A47, 0x0A48},   {0x0A4B, 0x0A4D},   {0x0A70, 0x0A71},
+            {0x0A81, 0x0A82},   {0x0ABC, 0x0ABC},   {0x0AC1, 0x0AC5},   {0x0AC7, 0x0AC8},   {0x0ACD, 0x0ACD},
+            {0x0AE2, 0x0AE3},   {0x0B01, 0x0B01},   {0x0B3C, 0x0B3C},   {0x0B3F, 0x0B3F},   {0x0B41, 0x0B43},
+            {0x0B4D, 0x0B4D},   {0x0B56, 0x0B56},   {0x0B82, 0x0B82},   {0x0BC0, 0x0BC0},   {0x0BCD, 0x0BCD},
+            {0x0C3E, 0x0C40},   {0x0C46, 0x0C48},   {0x0C4A, 0x0C4D},   {0x0C55, 0x0C56},   {0x0CBC, 0x0CBC},
+            {0x0CBF, 0x0CBF},   {0x0CC6, 0x0CC6},   {0x0CCC, 0x0CCD},   {0x0CE2, 0x0CE3},   {0x0D41, 0x0D43},
+            {0x0D4D, 0x0D4D},   {0x0DCA, 0x0DCA},   {0x0DD2, 0x0DD4},   {0x0DD6, 0x0DD6},   {0x0E31, 0x0E31},
+            {0x0E34, 0x0E3A},   {0x0E47, 0x0E4E},   {0x0EB1, 0x0EB1},   {0x0EB4, 0x0EB9},   {0x0EBB, 0x0EBC},
+            {0x0EC8, 0x0ECD},   {0x0F18, 0x0F19},   {0x0F35, 0x0F35},   {0x0F37, 0x0F37},   {0x0F39, 0x0F39},
+            {0x0F71, 0x0F7E},   {0x0F80, 0x0F84},   {0x0F86, 0x0F87},   {0x0F90, 0x0F97},   {0x0F99, 0x0FBC},
+            {0x0FC6, 0x0FC6},   {0x102D, 0x1030},   {0x1032, 0x1032},   {0x1036, 0x1037},   {0x1039, 0x1039},
+            {0x1058, 0x1059},   {0x1160, 0x11FF},   {0x135D, 0x135F},   {0x1712, 0x1714},   {0x1732, 0x1734},
+            {0x1752, 0x1753},   {0x1772, 0x1773},   {0x17B4, 0x17B5},   {0x17B7, 0x17BD},   {0x17C6, 0x17C6},
+            {0x17C9, 0x17D3},   {0x17DD, 0x17DD},   {0x180B, 0x180D},   {0x18A9, 0x18A9},   {0x1920, 0x1922},
+            {0x1927, 0x1928},   {0x1932, 0x1932},   {0x1939, 0x193B},   {0x1A17, 0x1A18},   {0x1AB0, 0x1AFF},
+            {0x1B00, 0x1B03},   {0x1B34, 0x1B34},   {0x1B36, 0x1B3A},   {0x1B3C, 0x1B3C},   {0x1B42, 0x1B42},
+            {0x1B6B, 0x1B73},   {0x1DC0, 0x1DFF},   {0x200B, 0x200F},   {0x202A, 0x202E},   {0x2060, 0x2064},
+            {0x206A, 0x206F},   {0x20D0, 0x20FF},   {0x2CEF, 0x2CF1},   {0x2DE0, 0x2DFF},   {0x302A, 0x302D},
+            {0x3099, 0x309A},   {0xA66F, 0xA672},   {0xA674, 0xA67D},   {0xA69E, 0xA69F},   {0xA6F0, 0xA6F1},
+            {0xA802, 0xA802},   {0xA806, 0xA806},   {0xA80B, 0xA80B},   {0xA825, 0xA826},   {0xA8C4, 0xA8C5},
+            {0xA8E0, 0xA8F1},   {0xFB1E, 0xFB1E},   {0xFE00, 0xFE0F},   {0xFE20, 0xFE2F},   {0xFEFF, 0xFEFF},
+            {0xFFF9, 0xFFFB},   {0x101FD, 0x101FD}, {0x1D167, 0x1D169}, {0x1D173, 0x1D182}, {0x1D185, 0x1D18B},
+            {0x1D1AA, 0x1D1AD}, {0x1F3FB, 0x1F3FF}, {0xE0001, 0xE0001}, {0xE0020, 0xE007F}, {0xE0100, 0xE01EF}};
 
         /**
-         * @brief
-         * @param other
-         * @return
+         * @brief Code points that take up two columns: East Asian wide and fullwidth characters, and emoji.
          */
-        TablePrinter& operator=(TablePrinter&& other) = delete;
+        constexpr CodePointRange WideCodePoints[] = {
+            {0x1100, 0x115F},   {0x231A, 0x231B},   {0x2329, 0x232A},   {0x23E9, 0x23EC},   {0x23F0, 0x23F0},
+            {0x23F3, 0x23F3},   {0x25FD, 0x25FE},   {0x2614, 0x2615},   {0x2648, 0x2653},   {0x267F, 0x267F},
+            {0x2693, 0x2693},   {0x26A1, 0x26A1},   {0x26AA, 0x26AB},   {0x26BD, 0x26BE},   {0x26C4, 0x26C5},
+            {0x26CE, 0x26CE},   {0x26D4, 0x26D4},   {0x26EA, 0x26EA},   {0x26F2, 0x26F3},   {0x26F5, 0x26F5},
+            {0x26FA, 0x26FA},   {0x26FD, 0x26FD},   {0x2705, 0x2705},   {0x270A, 0x270B},   {0x2728, 0x2728},
+            {0x274C, 0x274C},   {0x274E, 0x274E},   {0x2753, 0x2755},   {0x2757, 0x2757},   {0x2795, 0x2797},
+            {0x27B0, 0x27B0},   {0x27BF, 0x27BF},   {0x2B1B, 0x2B1C},   {0x2B50, 0x2B50},   {0x2B55, 0x2B55},
+            {0x2E80, 0x303E},   {0x3041, 0x3098},   {0x309B, 0x33FF},   {0x3400, 0x4DBF},   {0x4E00, 0x9FFF},
+            {0xA000, 0xA4CF},   {0xA960, 0xA97F},   {0xAC00, 0xD7A3},   {0xF900, 0xFAFF},   {0xFE10, 0xFE19},
+            {0xFE30, 0xFE6F},   {0xFF00, 0xFF60},   {0xFFE0, 0xFFE6},   {0x16FE0, 0x16FE4}, {0x17000, 0x18AFF},
+            {0x1B000, 0x1B2FF}, {0x1F004, 0x1F004}, {0x1F0CF, 0x1F0CF}, {0x1F18E, 0x1F18E}, {0x1F191, 0x1F19A},
+            {0x1F200, 0x1F251}, {0x1F300, 0x1F3FA}, {0x1F400, 0x1F64F}, {0x1F680, 0x1F6FF}, {0x1F7E0, 0x1F7EB},
+            {0x1F90C, 0x1F9FF}, {0x1FA70, 0x1FAFF}, {0x20000, 0x2FFFD}, {0x30000, 0x3FFFD}};
 
         /**
-         * @brief
-         * @return
+         * @brief Check whether a code point is in a sorted table of ranges.
          */
-        int GetColumnCount() const {
+        template<std::size_t N>
+        bool InRanges(const CodePointRange (&ranges)[N], char32_t codePoint) {
 
-            return m_columnTitles.size();
+            if (codePoint < ranges[0].first || codePoint > ranges[N - 1].last) return false;
+            auto it = std::upper_bound(std::begin(ranges), std::end(ranges), codePoint, [](char32_t value, const CodePointRange& range) {
+                return value < range.first;
+            });
+            return it != std::begin(ranges) && codePoint <= std::prev(it)->last;
         }
 
         /**
-         * @brief
-         * @return
+         * @brief Get the number of columns a code point takes up on a terminal: 0, 1 or 2.
          */
-        int GetTableWidth() const {
+        inline int CodePointWidth(char32_t codePoint) {
 
-            return m_tableWidth;
+            if (codePoint < 0x300) return 1;
+            if (InRanges(ZeroWidthCodePoints, codePoint)) return 0;
+            if (InRanges(WideCodePoints, codePoint)) return 2;
+            return 1;
         }
 
         /**
-         * @brief
-         * @param separator
+         * @brief Decode the UTF-8 sequence starting at a position in a text.
+         * @details Malformed sequences are decoded one byte at a time, as U+FFFD.
+         * @param text The text.
+         * @param position The position of the sequence; moved past it.
+         * @return The code point.
          */
-        void SetSeparator(const std::string& separator) {
+        inline char32_t DecodeUtf8(std::string_view text, std::size_t& position) {
 
-            m_columnSeparator = separator;
+            auto lead = static_cast<unsigned char>(text[position]);
+            if (lead < 0x80) {
+                ++position;
+                return lead;
+            }
+
+            std::size_t length    = lead >= 0xF0 && lead < 0xF5 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC2 && lead < 0xE0 ? 2 : 0;
+            char32_t    codePoint = lead & (0x7F >> length);
+            if (length == 0 || position + length > text.size()) {
+                ++position;
+                return 0xFFFD;
+            }
+
+            for (std::size_t i = 1; i < length; ++i) {
+                auto next = static_cast<unsigned char>(text[position + i]);
+                if ((next & 0xC0) != 0x80) {
+                    ++position;
+                    return 0xFFFD;
+                }
+                codePoint = (codePoint << 6) | (next & 0x3F);
+            }
+
+            position += length;
+            return codePoint;
         }
 
         /**
-         * @brief
+         * @brief Get the number of columns a text takes up on a terminal.
+         * @details Plain ASCII text, the common case, is recognized by IsAscii and measured by its size; other
+         * text is decoded code point by code point.
          */
-        void SetFlushLeft() {
+        inline std::size_t DisplayWidth(std::string_view text) {
 
-            m_flushLeft = true;
+            if (IsAscii(text)) return text.size();
+
+            std::size_t width = 0;
+            for (std::size_t position = 0; position < text.size();)
+                width += static_cast<std::size_t>(CodePointWidth(DecodeUtf8(text, position)));
+            return width;
         }
 
         /**
-         * @brief
+         * @brief Cut a text to a number of columns, without splitting a code point, and keeping the combining
+         * marks of the last character.
+         * @param text The text.
+         * @param width The number of columns.
+         * @return The longest prefix of the text that fits in the columns.
          */
-        void SetFlushRight() {
+        inline std::string_view TruncateToWidth(std::string_view text, std::size_t width) {
 
-            m_flushLeft = false;
+            if (text.size() <= width) {
+                if (IsAscii(text)) return text;
+            }
+            else if (IsAscii(text.substr(0, width + 1))) {
+                return text.substr(0, width);
+            }
+
+            std::size_t used     = 0;
+            std::size_t position = 0;
+            while (position < text.size()) {
+                auto next      = position;
+                auto codePoint = DecodeUtf8(text, next);
+                used += static_cast<std::size_t>(CodePointWidth(codePoint));
+                if (used > width) break;
+                position = next;
+            }
+            return text.substr(0, position);
         }
 
         /**
-         * @brief
-         * @param columnTitle
-         * @param columnWidth
+         * @brief Take the next line from a text being word wrapped.
+         * @details Lines are broken at the last space that fits, or at a newline. A word too long for a line is
+         * broken where the line is full, on a code point boundary. Spaces at a break are dropped; indentation
+         * after a newline is kept.
+         * @param text The rest of the text; moved past the line.
+         * @param width The width of the lines.
+         * @return A view of the line.
          */
-        void AddColumn(const std::string& columnTitle, int columnWidth) {
+        inline std::string_view NextWrappedLine(std::string_view& text, std::size_t width) {
 
-            if (columnWidth < 4) {
-                throw std::invalid_argument("Column width has to be >= 4");
+            auto        fit     = TruncateToWidth(text, width);
+            auto        newline = fit.find('\n');
+            std::size_t end     = fit.size();
+            std::size_t next    = fit.size();
+            bool        trim    = false;
+
+            if (newline != std::string_view::npos) {
+                end  = newline;
+                next = newline + 1;
+            }
+            else if (fit.size() == text.size()) {
+            }
+            else if (text[fit.size()] == '\n') {
+                next = fit.size() + 1;
+            }
+            else if (text[fit.size()] == ' ') {
+                trim = true;
+            }
+            else if (auto space = fit.rfind(' '); space != std::string_view::npos && space > 0) {
+                end  = space;
+                next = space + 1;
+                trim = true;
+            }
+            else if (fit.empty()) {
+                DecodeUtf8(text, next); // not even one character fits; take it anyway
+                end = next;
             }
 
-            m_columnTitles.emplace_back(columnTitle);
-            m_columnWidths.emplace_back(columnWidth);
-            m_tableWidth += columnWidth + m_columnSeparator.size(); // for the separator
+            auto line = text.substr(0, end);
+            while (!line.empty() && line.back() == ' ') line.remove_suffix(1);
+            text.remove_prefix(next);
+            while (trim && !text.empty() && text.front() == ' ') text.remove_prefix(1);
+            return line;
         }
 
         /**
-         * @brief
-         * @param title
+         * @brief Append text to a buffer, padded with spaces to the given width.
+         * @param buffer The buffer to append to.
+         * @param text The text to append. Text wider than the column is appended in full.
+         * @param width The column width.
+         * @param flushLeft If true, the text is left aligned; otherwise it is right aligned.
          */
-        void PrintTitle(const std::string& title) {
+        inline void AppendPadded(std::string& buffer, std::string_view text, int width, bool flushLeft) {
 
-            auto totalWidth = 0;
-            for (auto& it : m_columnWidths) totalWidth += it;
-            totalWidth += m_columnWidths.size() - 1;
+            auto padding = width - static_cast<int>(DisplayWidth(text));
+            if (padding > 0 && !flushLeft) buffer.append(static_cast<std::size_t>(padding), ' ');
+            buffer.append(text.data(), text.size());
+            if (padding > 0 && flushLeft) buffer.append(static_cast<std::size_t>(padding), ' ');
+        }
 
-            auto tit        = title;
-            auto titleWidth = tit.length();
-            if (titleWidth > totalWidth) tit = tit.substr(0, totalWidth);
+        /**
+         * @brief Size of the scratch buffer used for number formatting; large enough for any double in fixed notation.
+         */
+        constexpr std::size_t NumberBufferSize = 512;
 
-            auto pre  = (totalWidth - tit.length()) / 2;
-            auto post = (totalWidth - tit.length() - pre);
+        /**
+         * @brief Stack allocated scratch buffer for the number formatting functions.
+         */
+        using NumberBuffer = std::array<char, NumberBufferSize>;
 
-            PrintHorizontalLine('=');
-            m_outStream << "|";
-            for (int i = 0; i < pre; ++i) m_outStream << " ";
-            m_outStream << tit;
-            for (int i = 0; i < post; ++i) m_outStream << " ";
-            m_outStream << "|\n";
+        /**
+         * @brief Format a number using the shortest representation that round-trips.
+         * @tparam T The number type.
+         * @param buffer The scratch buffer to format into.
+         * @param value The value to format.
+         * @return A view of the formatted text, or an empty view if the value could not be formatted.
+         */
+        template<typename T>
+        std::string_view FormatShortest(NumberBuffer& buffer, T value) {
 
+            auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+            if (result.ec != std::errc()) return {};
+            return {buffer.data(), static_cast<std::size_t>(result.ptr - buffer.data())};
         }
 
         /**
-         * @brief
+         * @brief Format a floating point number in fixed notation with the given number of decimals.
+         * @tparam T The floating point type.
+         * @param buffer The scratch buffer to format into.
+         * @param value The value to format.
+         * @param precision The number of decimals.
+         * @return A view of the formatted text, or an empty view if the value does not fit in the buffer.
          */
-        void PrintHeader() {
+        template<typename T>
+        std::string_view FormatFixed(NumberBuffer& buffer, T value, int precision) {
+
+            auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::fixed, precision);
+            if (result.ec != std::errc()) return {};
+            return {buffer.data(), static_cast<std::size_t>(result.ptr - buffer.data())};
+        }
 
-            PrintHorizontalLine('=');
-            m_outStream << "|";
+        /**
+         * @brief Cut formatted text (located at the start of the buffer) to the given width and mark the last
+         * character with an asterisk, to indicate that the value could not be shown in full.
+         * @param buffer The buffer holding the text.
+         * @param text The text, which must start at the beginning of the buffer.
+         * @param width The width to cut the text to.
+         * @param marker The character marking the cut.
+         * @return A view of the marked text.
+         */
+        inline std::string_view MarkOverflow(NumberBuffer& buffer, std::string_view text, int width, char marker = '*') {
 
-            for (int i = 0; i < GetColumnCount(); ++i) {
+            auto length = std::min(static_cast<std::size_t>(std::max(width, 0)), buffer.size());
+            if (length == 0) return {};
+            if (text.size() < length) std::fill(buffer.data() + text.size(), buffer.data() + length, ' ');
+            buffer[length - 1] = marker;
+            return {buffer.data(), length};
+        }
 
-                if (m_flushLeft)
-                    m_outStream << std::left;
-                else
-                    m_outStream << std::right;
+        /**
+         * @brief Format a floating point number in fixed notation, using as many decimals as will fit in the
+         * given width.
+         * @details If the integer part of the number is too wide for the column, the text is cut and the last
+         * character is replaced with an asterisk. The same marker is used when a non-zero value would be shown
+         * as zero. No heap allocations are made and no stream state is involved, so the output is independent
+         * of the global locale.
+         * @tparam T The floating point type.
+         * @param buffer The scratch buffer to format into.
+         * @param value The value to format.
+         * @param width The width of the column.
+         * @param marker The character marking a value that could not be shown in full.
+         * @return A view of the formatted text, which will be no wider than the column.
+         */
+        template<typename T>
+        std::string_view FormatFixedToWidth(NumberBuffer& buffer, T value, int width, char marker = '*') {
+
+            if (!std::isfinite(value)) {
+                auto text = FormatShortest(buffer, value);
+                return static_cast<int>(text.size()) <= width ? text : MarkOverflow(buffer, text, width, marker);
+            }
 
-                m_outStream << std::setw(m_columnWidths.at(i)) << m_columnTitles.at(i).substr(0, m_columnWidths.at(i));
-                if (i != GetColumnCount() - 1) {
-                    m_outStream << m_columnSeparator;
+            // Format the value without decimals first, to find the width of the integer part.
+            auto text = FormatFixed(buffer, value, 0);
+            if (text.empty()) {
+                text = FormatShortest(buffer, value);
+                return static_cast<int>(text.size()) <= width ? text : MarkOverflow(buffer, text, width, marker);
+            }
+
+            auto integerWidth = static_cast<int>(text.size());
+            if (integerWidth > width) return MarkOverflow(buffer, text, width, marker);
+
+            // Rounding to zero decimals may have added a digit (e.g. 99.9 -> 100), so try one more decimal than
+            // the integer part suggests, and back off if it does not fit. Leave room for the decimal point.
+            auto maxPrecision = static_cast<int>(buffer.size()) - integerWidth - 2;
+            for (auto precision = std::min(width - integerWidth, maxPrecision); precision > 0; --precision) {
+                auto decimals = FormatFixed(buffer, value, precision);
+                if (static_cast<int>(decimals.size()) <= width) {
+                    text = decimals;
+                    break;
                 }
+                if (precision == 1) text = FormatFixed(buffer, value, 0);
             }
 
-            m_outStream << "|\n";
-            PrintHorizontalLine('=');
+            if (value != 0 && text.find_first_of("123456789") == std::string_view::npos)
+                return MarkOverflow(buffer, text, static_cast<int>(text.size()), marker);
+
+            return text;
         }
 
         /**
-         * @brief
+         * @brief Count the decimal digits of an integer, including the sign, without formatting it.
          */
-        void PrintFooter() {
+        template<typename T>
+        int IntegerWidth(T value) {
+
+            using Unsigned = std::make_unsigned_t<T>;
+            auto magnitude = static_cast<Unsigned>(value);
+            auto width     = 1;
+            if constexpr(std::is_signed<T>::value) {
+                if (value < 0) {
+                    magnitude = static_cast<Unsigned>(Unsigned(0) - magnitude);
+                    ++width;
+                }
+            }
 
-            PrintHorizontalLine();
+            // Four digits per division.
+            for (;;) {
+                if (magnitude < 10) return width;
+                if (magnitude < 100) return width + 1;
+                if (magnitude < 1000) return width + 2;
+                if (magnitude < 10000) return width + 3;
+                magnitude /= 10000;
+                width += 4;
+            }
         }
 
         /**
-         *
+         * @brief Format an integer, cut to the column width and marked with an asterisk if it is too wide, like
+         * FormatFixedToWidth does with floating point numbers.
+         * @details std::to_chars computes the number of digits up front and converts two digits at a time, so
+         * this is the cheapest cell type to format.
+         * @tparam T The integer type.
+         * @param buffer The scratch buffer to format into.
+         * @param value The value to format.
+         * @param width The width of the column.
+         * @return A view of the formatted text, which will be no wider than the column.
          */
-        TablePrinter& operator<<(endl input) {
+        template<typename T>
+        std::string_view FormatIntegerToWidth(NumberBuffer& buffer, T value, int width) {
 
-            while (m_columnIndex != 0) {
-                *this << "";
-            }
-            return *this;
+            auto text = FormatShortest(buffer, value);
+            return static_cast<int>(text.size()) <= width ? text : MarkOverflow(buffer, text, width);
         }
 
         /**
-         * @brief
-         * @tparam T
-         * @param input
-         * @return
+         * @brief Is T an integer type that is stored (and printed) as a number, rather than as text?
+         * @details bool and the character types are printed as text by the stream insertion operator, so they are
+         * stored as text as well.
          */
         template<typename T>
-        TablePrinter& operator<<(T input) {
+        constexpr bool IsStoredAsInteger = std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                                           !std::is_same<T, char>::value && !std::is_same<T, signed char>::value &&
+                                           !std::is_same<T, unsigned char>::value && !std::is_same<T, wchar_t>::value &&
+                                           !std::is_same<T, char16_t>::value && !std::is_same<T, char32_t>::value;
+
+        /**
+         * @brief The number format of a column, compiled from a format specification once, when the column is
+         * added, so that formatting a cell involves no parsing.
+         * @details A specification has the form [align][,][.precision][type][!marker], e.g. ",.2f" or ">.1s":
+         *  - align: '<' or '>' aligns the cells of the column left or right, instead of as the rest of the table;
+         *  - ',': separates the thousands with commas;
+         *  - precision: the number of decimals (for 'g', the number of significant digits);
+         *  - type: 'f' fixed, 'e' scientific, 'g' shortest round-trip, 's' SI suffixes (1.2k, 3.4M) or 'i' binary
+         *    suffixes (1.5Ki, 3.4Mi); without a type, numbers are printed as without a format;
+         *  - marker: the character marking a number too wide for its column, '*' by default.
+         *
+         * Fixed and scientific numbers without a precision get as many decimals as fit in the column, and numbers
+         * with a suffix get one. Integers stay integers, unless they are printed in scientific notation, with a
+         * precision for 'f' or 'g', or scaled down by a suffix.
+         */
+        class NumberFormat {
+        public:
+
+            /**
+             * @brief The notation of the numbers.
+             */
+            enum class Notation : char { Auto, Fixed, Scientific, Shortest };
+
+            /**
+             * @brief The unit suffixes that large numbers are scaled down with.
+             */
+            enum class Suffix : char { None, Si, Binary };
+
+            /**
+             * @brief Default constructor: numbers are printed as without a format.
+             */
+            NumberFormat() = default;
+
+            /**
+             * @brief Constructor, compiling a format specification.
+             * @param spec The format specification, as described above.
+             * @throws std::invalid_argument if the specification is malformed.
+             */
+            explicit NumberFormat(std::string_view spec) {
+
+                std::size_t pos = 0;
+                auto        at  = [&](char c) { return pos < spec.size() && spec[pos] == c; };
+
+                if (at('<') || at('>')) m_align = spec[pos++];
+                if (at(',')) {
+                    m_thousands = ',';
+                    ++pos;
+                }
+                if (at('.')) {
+                    auto start = ++pos;
+                    m_precision = 0;
+                    for (; pos < spec.size() && spec[pos] >= '0' && spec[pos] <= '9'; ++pos) {
+                        m_precision = m_precision * 10 + (spec[pos] - '0');
+                        if (m_precision > 100) throw std::invalid_argument("Number format precision has to be <= 100");
+                    }
+                    if (pos == start) throw std::invalid_argument("Number format is missing the precision after '.'");
+                }
+                if (pos < spec.size()) {
+                    switch (spec[pos]) {
+                        case 'f':
+                            m_notation = Notation::Fixed;
+                            ++pos;
+                            break;
+                        case 'e':
+                            m_notation = Notation::Scientific;
+                            ++pos;
+                            break;
+                        case 'g':
+                            m_notation = Notation::Shortest;
+                            ++pos;
+                            break;
+                        case 's':
+                            m_suffix = Suffix::Si;
+                            ++pos;
+                            break;
+                        case 'i':
+                            m_suffix = Suffix::Binary;
+                            ++pos;
+                            break;
+                        default:
+                            break;
+                    }
+                }
+                if (at('!')) {
+                    if (++pos == spec.size()) throw std::invalid_argument("Number format is missing the marker after '!'");
+                    m_marker = spec[pos++];
+                }
+
+                if (pos != spec.size()) {
+                    throw std::invalid_argument("Invalid number format \"" + std::string(spec) + "\"");
+                }
+            }
 
-            if constexpr(std::is_floating_point<T>::value) {
-                OutputDecimalNumber<T>(input);
+            /**
+             * @brief Are numbers printed as without a format?
+             */
+            bool IsDefault() const {
+
+                return m_notation == Notation::Auto && m_precision < 0 && m_thousands == 0 && m_suffix == Suffix::None &&
+                       m_marker == '*';
             }
-            else {
 
-                if (m_columnIndex == 0)
-                    m_outStream << "|";
+            /**
+             * @brief Get the alignment of the column: '<' for left, '>' for right, or 0 for that of the table.
+             */
+            char Alignment() const {
 
-                if (m_flushLeft)
-                    m_outStream << std::left;
-                else
-                    m_outStream << std::right;
+                return m_align;
+            }
+
+            /**
+             * @brief Get the character marking a number too wide for its column.
+             */
+            char Marker() const {
+
+                return m_marker;
+            }
+
+            /**
+             * @brief Format a number for a column.
+             * @tparam T An integer or floating point type.
+             * @param buffer The scratch buffer to format into.
+             * @param value The value.
+             * @param width The column width. Wider text is cut, and marked with the overflow marker.
+             * @return A view of the text in the buffer.
+             */
+            template<typename T>
+            std::string_view Format(NumberBuffer& buffer, T value, int width) const {
+
+                auto text = Apply(buffer, value, width, true);
+                return static_cast<int>(text.size()) <= width ? text : MarkOverflow(buffer, text, width, m_marker);
+            }
+
+            /**
+             * @brief Get the width a number needs to be shown in full, with the shortest decimals where the
+             * precision is not fixed.
+             */
+            template<typename T>
+            int NaturalWidth(T value) const {
+
+                NumberBuffer buffer;
+                return static_cast<int>(Apply(buffer, value, 0, false).size());
+            }
+
+        private:
 
-                // Leave 3 extra space: One for negative sign, one for zero, one for decimal
-                m_outStream << std::setw(m_columnWidths.at(m_columnIndex));
-                m_outStream << input;
+            /**
+             * @brief Format a number, scaled down and suffixed if requested, but not cut to the column width.
+             * @param fit Fit the decimals to the width, where the precision is not fixed? Otherwise use the
+             * shortest decimals that represent the value.
+             */
+            template<typename T>
+            std::string_view Apply(NumberBuffer& buffer, T value, int width, bool fit) const {
 
-                if (m_columnIndex == GetColumnCount() - 1) {
-                    m_outStream << "|\n";
-                    m_rowIndex    = m_rowIndex + 1;
-                    m_columnIndex = 0;
+                static constexpr std::string_view siSuffixes[]     = {"", "k", "M", "G", "T", "P", "E"};
+                static constexpr std::string_view binarySuffixes[] = {"", "Ki", "Mi", "Gi", "Ti", "Pi", "Ei"};
+
+                if (m_suffix == Suffix::None) return Digits(buffer, value, width, fit);
+
+                auto        base     = m_suffix == Suffix::Si ? 1000.0 : 1024.0;
+                auto        scaled   = static_cast<double>(value);
+                std::size_t exponent = 0;
+                while (std::abs(scaled) >= base && exponent + 1 < std::size(siSuffixes)) {
+                    scaled /= base;
+                    ++exponent;
+                }
+
+                // A mantissa just below the base may round up to it, e.g. 999999 to "1000.0k"; use the next suffix.
+                if (exponent + 1 < std::size(siSuffixes) && RoundsToBase(scaled, base)) {
+                    scaled /= base;
+                    ++exponent;
+                }
+                if (exponent == 0) return Digits(buffer, value, width, fit);
+
+                auto suffix = (m_suffix == Suffix::Si ? siSuffixes : binarySuffixes)[exponent];
+                auto text   = Digits(buffer, scaled, width - static_cast<int>(suffix.size()), fit);
+                if (text.size() + suffix.size() > buffer.size()) return text;
+                std::copy(suffix.begin(), suffix.end(), buffer.data() + text.size());
+                return {buffer.data(), text.size() + suffix.size()};
+            }
+
+            /**
+             * @brief Does a mantissa reach the base of the suffixes once rounded to the decimals it is printed with?
+             */
+            bool RoundsToBase(double mantissa, double base) const {
+
+                if (!(std::abs(mantissa) >= base - 0.5) || !std::isfinite(mantissa)) return false;
+
+                NumberBuffer digits;
+                auto         text    = FormatFixed(digits, std::abs(mantissa), m_precision < 0 ? 1 : m_precision);
+                double       rounded = 0.0;
+                std::from_chars(text.data(), text.data() + text.size(), rounded);
+                return rounded >= base;
+            }
+
+            /**
+             * @brief Format the digits of a number, with thousands separators if requested.
+             */
+            template<typename T>
+            std::string_view Digits(NumberBuffer& buffer, T value, int width, bool fit) const {
+
+                if constexpr(std::is_integral<T>::value) {
+                    auto keepInteger = m_suffix != Suffix::None || m_notation == Notation::Auto ||
+                                       (m_notation != Notation::Scientific && m_precision < 0);
+                    if (keepInteger) return Group(buffer, FormatShortest(buffer, value));
+                    return Digits(buffer, static_cast<double>(value), width, fit);
                 }
                 else {
-                    m_outStream << m_columnSeparator;
-                    ++m_columnIndex;
+                    if (!std::isfinite(value)) return FormatShortest(buffer, value);
+                    if (m_suffix != Suffix::None) return Group(buffer, FormatFixed(buffer, value, m_precision < 0 ? 1 : m_precision));
+
+                    switch (m_notation) {
+                        case Notation::Scientific:
+                            return Scientific(buffer, value, width, fit);
+                        case Notation::Shortest: {
+                            auto result = m_precision < 0
+                                              ? std::to_chars(buffer.data(), buffer.data() + buffer.size(), value)
+                                              : std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::general, m_precision);
+                            return Group(buffer, {buffer.data(), static_cast<std::size_t>(result.ptr - buffer.data())});
+                        }
+                        default:
+                            break;
+                    }
+
+                    if (m_precision >= 0) return Group(buffer, FormatFixed(buffer, value, m_precision));
+                    if (!fit) {
+                        auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::fixed);
+                        return Group(buffer, {buffer.data(), static_cast<std::size_t>(result.ptr - buffer.data())});
+                    }
+                    if (m_thousands == 0) return FormatFixedToWidth(buffer, value, width, m_marker);
+
+                    // Leave room for the separators when fitting the decimals.
+                    auto integer    = FormatFixed(buffer, value, 0);
+                    auto digits     = static_cast<int>(integer.size()) - (value < 0 ? 1 : 0);
+                    auto separators = std::max(digits - 1, 0) / 3;
+                    if (static_cast<int>(integer.size()) + separators > width) return Group(buffer, integer);
+
+                    auto text = FormatFixedToWidth(buffer, value, width - separators, m_marker);
+                    return !text.empty() && text.back() == m_marker ? text : Group(buffer, text);
                 }
             }
-            return *this;
-        }
 
-    private:
+            /**
+             * @brief Format a floating point number in scientific notation.
+             */
+            template<typename T>
+            std::string_view Scientific(NumberBuffer& buffer, T value, int width, bool fit) const {
 
-        /**
-         * @brief
-         * @param character
-         */
-        void PrintHorizontalLine(char character = '-') {
+                auto format = [&](int precision) {
+                    auto result = precision < 0
+                                      ? std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::scientific)
+                                      : std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::scientific, precision);
+                    return std::string_view(buffer.data(), static_cast<std::size_t>(result.ptr - buffer.data()));
+                };
+
+                if (m_precision >= 0) return format(m_precision);
+                if (!fit) return format(-1);
 
-            m_outStream << "+"; // the left bar
+                // The mantissa without decimals, e.g. "1e+05", shows how much room is left for the decimals and
+                // the decimal point. Rounding may carry into the exponent, so back off if the result is too wide.
+                auto precision = std::min(width - static_cast<int>(format(0).size()) - 1, 17);
+                for (; precision > 0; --precision) {
+                    auto text = format(precision);
+                    if (static_cast<int>(text.size()) <= width) return text;
+                }
+                return format(0);
+            }
 
-            for (int i = 0; i < m_tableWidth - 1; ++i)
-                m_outStream << character;
+            /**
+             * @brief Insert thousands separators into the integer part of a number at the start of the buffer.
+             */
+            std::string_view Group(NumberBuffer& buffer, std::string_view text) const {
 
-            m_outStream << "+"; // the right bar
-            m_outStream << "\n";
-        }
+                if (m_thousands == 0 || text.empty()) return text;
+
+                std::size_t start = text[0] == '-' ? 1 : 0;
+                auto        end   = start;
+                while (end < text.size() && text[end] >= '0' && text[end] <= '9') ++end;
+                if (end - start <= 3 || text.find('e') != std::string_view::npos) return text;
+
+                auto count = (end - start - 1) / 3;
+                if (text.size() + count > buffer.size()) return text;
+
+                // Move the rest of the number right, then the digits, inserting a separator after every third.
+                std::copy_backward(buffer.data() + end, buffer.data() + text.size(), buffer.data() + text.size() + count);
+                auto to = end + count;
+                for (std::size_t from = end, copied = 0; from > start;) {
+                    buffer[--to] = buffer[--from];
+                    if (++copied % 3 == 0 && from > start) buffer[--to] = m_thousands;
+                }
+                return {buffer.data(), text.size() + count};
+            }
+
+            Notation m_notation{Notation::Auto}; /**< the notation */
+            Suffix   m_suffix{Suffix::None}; /**< the unit suffixes */
+            int      m_precision{-1}; /**< the number of decimals; negative if not given */
+            char     m_thousands{0}; /**< the thousands separator, or 0 for none */
+            char     m_align{0}; /**< '<', '>' or 0; see Alignment */
+            char     m_marker{'*'}; /**< the overflow marker */
+        };
 
         /**
-         * @brief
-         * @tparam T
-         * @param input
+         * @brief Formats cell values of any type into a row buffer.
+         * @details Strings are copied straight into the buffer, integers are formatted with FormatIntegerToWidth,
+         * floating point numbers with FormatFixedToWidth, and all other types with their stream insertion
+         * operator on a private stream, so the state of the output stream is never touched.
          */
-        template<typename T>
-        void OutputDecimalNumber(T input) {
-            // If we cannot handle this number, indicate so
-            if (input < 10 * (m_columnWidths.at(m_columnIndex) - 1) || input > 10 * m_columnWidths.at(m_columnIndex)) {
-                std::stringstream string_out;
-                string_out << std::setiosflags(std::ios::fixed) << std::setprecision(m_columnWidths.at(m_columnIndex))
-                           << std::setw(m_columnWidths.at(m_columnIndex)) << input;
+        class CellFormatter {
+        public:
 
-                std::string string_rep_of_number = string_out.str();
+            /**
+             * @brief Constructor.
+             */
+            CellFormatter() {
 
-                string_rep_of_number[m_columnWidths.at(m_columnIndex) - 1] = '*';
-                std::string string_to_print = string_rep_of_number.substr(0, m_columnWidths.at(m_columnIndex));
-                m_outStream << string_to_print;
+                m_buffer.SetTarget(&m_text);
             }
-            else {
 
-                // determine what precision we need
-                int precision = m_columnWidths.at(m_columnIndex) - 1; // leave room for the decimal point
-                if (input < 0)
-                    --precision; // leave room for the minus sign
+            /**
+             * @brief The formatter holds a stream pointing into itself, so it can be neither copied nor moved.
+             */
+            CellFormatter(const CellFormatter& other) = delete;
 
-                // leave room for digits before the decimal?
-                if (input < -1 || input > 1) {
-                    int num_digits_before_decimal = 1 + static_cast<int>(log10(std::abs(input)));
-                    precision -= num_digits_before_decimal;
-                }
-                else
-                    precision--; // e.g. 0.12345 or -0.1234
+            /**
+             * @brief The formatter holds a stream pointing into itself, so it can be neither copied nor moved.
+             */
+            CellFormatter& operator=(const CellFormatter& other) = delete;
 
-                if (precision < 0)
-                    precision = 0; // don't go negative with precision
+            /**
+             * @brief Format a value and append it to a buffer, padded to the column width.
+             * @tparam T The type of the value.
+             * @param buffer The buffer to append to.
+             * @param value The value to format.
+             * @param width The column width.
+             * @param flushLeft If true, the text is left aligned; otherwise it is right aligned.
+             * @param format The number format of the column.
+             */
+            template<typename T>
+            void Append(std::string& buffer, const T& value, int width, bool flushLeft, const NumberFormat& format = NumberFormat()) {
 
-                m_outStream << std::setiosflags(std::ios::fixed) << std::setprecision(precision)
-                            << std::setw(m_columnWidths.at(m_columnIndex)) << input;
+                NumberBuffer number;
+                AppendPadded(buffer, Format(number, value, width, format), width, flushLeft);
             }
 
-            if (m_columnIndex == GetColumnCount() - 1) {
-                m_outStream << "|\n";
-                m_rowIndex    = m_rowIndex + 1;
-                m_columnIndex = 0;
+            /**
+             * @brief Format a value for a column, without padding.
+             * @tparam T The type of the value.
+             * @param number Scratch buffer for numbers.
+             * @param value The value to format.
+             * @param width The column width.
+             * @param format The number format of the column.
+             * @return A view of the text, valid until the next call to the formatter or until number is reused.
+             */
+            template<typename T>
+            std::string_view Format(NumberBuffer& number, const T& value, int width, const NumberFormat& format = NumberFormat()) {
+
+                if constexpr(std::is_floating_point<T>::value) {
+                    return format.IsDefault() ? FormatFixedToWidth(number, value, width) : format.Format(number, value, width);
+                }
+                else if constexpr(std::is_convertible<const T&, std::string_view>::value) {
+                    return std::string_view(value);
+                }
+                else if constexpr(IsStoredAsInteger<T>) {
+                    return format.IsDefault() ? FormatIntegerToWidth(number, value, width) : format.Format(number, value, width);
+                }
+                else {
+                    return Stringify(value);
+                }
             }
-            else {
-                m_outStream << m_columnSeparator;
-                m_columnIndex = m_columnIndex + 1;
+
+            /**
+             * @brief Format a value of a type without a dedicated formatting path (i.e. not a string, integer or
+             * floating point number) with its stream insertion operator.
+             * @tparam T The type of the value.
+             * @param value The value to format.
+             * @return A view of the text, valid until the next call to the formatter.
+             */
+            template<typename T>
+            std::string_view Stringify(const T& value) {
+
+                m_text.clear();
+                m_stream << value;
+                return m_text;
             }
-        }
 
-        std::ostream& m_outStream; /**< */
-        std::vector<std::string> m_columnTitles; /**< */
-        std::vector<int>         m_columnWidths; /**< */
-        std::string              m_columnSeparator; /**< */
+        private:
+            std::string        m_text; /**< scratch text for cells formatted through the stream */
+            StringAppendBuffer m_buffer; /**< stream buffer appending to m_text */
+            std::ostream       m_stream{&m_buffer}; /**< private stream used for formatting non-string cells */
+        };
 
-        int m_rowIndex{0}; /**< index of current row */
-        int m_columnIndex{0}; /**< index of current column */
+        /**
+         * @brief Replace a container with an empty one that allocates from another memory resource.
+         * @details Polymorphic allocators are not replaced by assignment, so the container is rebuilt in place.
+         */
+        template<typename Container>
+        void Rebind(Container& container, std::pmr::memory_resource* resource) noexcept {
+
+            container.~Container();
+            new (&container) Container(resource);
+        }
+
+        /**
+         * @brief A cell value held in a RowStore.
+         * @details Numbers are kept as numbers, so they can be formatted for whatever width the column ends up
+         * with; everything else is kept as text in the text arena of the store.
+         */
+        struct StoredCell {
+
+            /**
+             * @brief The kind of value held by the cell.
+             */
+            enum class Kind : std::uint8_t { Text, Integer, Unsigned, Float, Double };
+
+            union {
+                long long          integer; /**< the value of an Integer cell */
+                unsigned long long unsignedInteger; /**< the value of an Unsigned cell */
+                double             floating; /**< the value of a Float or Double cell */
+                std::size_t        offset; /**< the offset of the text of a Text cell in the text arena */
+            };
+            std::uint32_t length{0}; /**< the length of the text of a Text cell */
+            Kind          kind{Kind::Text}; /**< the kind of value */
+        };
+
+        /**
+         * @brief Holds the cells of buffered rows, for the table modes that print rows after they have been
+         * received.
+         * @details The cells of all rows are kept back to back in one vector, and all text in one arena string,
+         * so a table of any size is held in two allocations.
+         */
+        class RowStore {
+        public:
+
+            /**
+             * @brief Constructor.
+             * @param resource The memory resource the cells and their text are allocated from.
+             */
+            explicit RowStore(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+                    : m_cells(resource),
+                      m_text(resource) {}
+
+            /**
+             * @brief Append a cell to the store. Rows are formed by the cells of consecutive calls.
+             * @tparam T The type of the value.
+             * @param value The value.
+             * @param formatter The formatter used to convert values without a dedicated path to text.
+             * @return The stored cell.
+             */
+            template<typename T>
+            const StoredCell& Push(const T& value, CellFormatter& formatter) {
+
+                StoredCell cell;
+                if constexpr(std::is_same<T, float>::value) {
+                    cell.kind     = StoredCell::Kind::Float;
+                    cell.floating = value;
+                }
+                else if constexpr(std::is_floating_point<T>::value) {
+                    cell.kind     = StoredCell::Kind::Double;
+                    cell.floating = static_cast<double>(value);
+                }
+                else if constexpr(IsStoredAsInteger<T> && std::is_signed<T>::value) {
+                    cell.kind    = StoredCell::Kind::Integer;
+                    cell.integer = value;
+                }
+                else if constexpr(IsStoredAsInteger<T>) {
+                    cell.kind            = StoredCell::Kind::Unsigned;
+                    cell.unsignedInteger = value;
+                }
+                else if constexpr(std::is_convertible<const T&, std::string_view>::value) {
+                    AppendText(cell, std::string_view(value));
+                }
+                else {
+                    AppendText(cell, formatter.Stringify(value));
+                }
+
+                m_cells.push_back(cell);
+                return m_cells.back();
+            }
+
+            /**
+             * @brief Append a copy of a cell from another store.
+             * @param source The store holding the cell.
+             * @param cell The cell.
+             * @return The stored cell.
+             */
+            const StoredCell& PushCopy(const RowStore& source, const StoredCell& cell) {
+
+                if (cell.kind != StoredCell::Kind::Text) {
+                    m_cells.push_back(cell);
+                }
+                else {
+                    StoredCell copy;
+                    AppendText(copy, source.Text(cell));
+                    m_cells.push_back(copy);
+                }
+                return m_cells.back();
+            }
+
+            /**
+             * @brief Get the number of cells in the store.
+             * @return The number of cells.
+             */
+            std::size_t CellCount() const {
+
+                return m_cells.size();
+            }
+
+            /**
+             * @brief Get a pointer to the cells of a row.
+             * @param row The index of the row.
+             * @param columnCount The number of columns in the table.
+             * @return A pointer to the first cell in the row.
+             */
+            const StoredCell* Row(std::size_t row, std::size_t columnCount) const {
+
+                return m_cells.data() + row * columnCount;
+            }
+
+            /**
+             * @brief Get the text of a Text cell.
+             * @param cell The cell.
+             * @return A view of the text, valid until the store is modified.
+             */
+            std::string_view Text(const StoredCell& cell) const {
+
+                return std::string_view(m_text).substr(cell.offset, cell.length);
+            }
+
+            /**
+             * @brief Remove all cells from the store. The memory is kept for reuse.
+             */
+            void Clear() {
+
+                m_cells.clear();
+                m_text.clear();
+            }
+
+            /**
+             * @brief Remove the last row, which must be complete, along with its text.
+             * @param columnCount The number of columns in the table.
+             */
+            void DropLastRow(std::size_t columnCount) {
+
+                auto first = m_cells.size() - columnCount;
+                for (auto cell = first; cell < m_cells.size(); ++cell) {
+                    if (m_cells[cell].kind == StoredCell::Kind::Text) {
+                        m_text.resize(m_cells[cell].offset); // the text of a row follows that of the rows before it
+                        break;
+                    }
+                }
+                m_cells.resize(first);
+            }
+
+            /**
+             * @brief Keep some of the rows, and the cells of an incomplete row following them, and remove the rest.
+             * @details The rows are moved to the front in place, so nothing is allocated.
+             * @param rows The indices of the rows to keep, in ascending order. They become rows 0, 1, 2...
+             * @param rowCount The number of complete rows in the store.
+             * @param columnCount The number of columns in the table.
+             */
+            void KeepRows(const std::vector<std::size_t>& rows, std::size_t rowCount, std::size_t columnCount) {
+
+                std::size_t cellEnd = 0;
+                std::size_t textEnd = 0;
+                auto        keep    = [&](std::size_t cell) {
+                    auto moved = m_cells[cell];
+                    if (moved.kind == StoredCell::Kind::Text) {
+                        std::memmove(&m_text[textEnd], m_text.data() + moved.offset, moved.length);
+                        moved.offset = textEnd;
+                        textEnd     += moved.length;
+                    }
+                    m_cells[cellEnd++] = moved;
+                };
+
+                for (auto row : rows)
+                    for (std::size_t column = 0; column < columnCount; ++column) keep(row * columnCount + column);
+                for (auto cell = rowCount * columnCount; cell < m_cells.size(); ++cell) keep(cell);
+
+                m_cells.resize(cellEnd);
+                m_text.resize(textEnd);
+            }
+
+            /**
+             * @brief Remove all cells from the store, and allocate from another memory resource from now on.
+             */
+            void Rebind(std::pmr::memory_resource* resource) noexcept {
+
+                detail::Rebind(m_cells, resource);
+                detail::Rebind(m_text, resource);
+            }
+
+            /**
+             * @brief Remove all cells from the store, and give the memory back to the memory resource.
+             */
+            void Release() {
+
+                std::pmr::vector<StoredCell>(m_cells.get_allocator()).swap(m_cells);
+                std::pmr::string(m_text.get_allocator()).swap(m_text);
+            }
+
+        private:
+
+            void AppendText(StoredCell& cell, std::string_view text) {
+
+                cell.kind   = StoredCell::Kind::Text;
+                cell.offset = m_text.size();
+                cell.length = static_cast<std::uint32_t>(text.size());
+                m_text.append(text.data(), text.size());
+            }
+
+            std::pmr::vector<StoredCell> m_cells; /**< the cells of all rows, row by row */
+            std::pmr::string             m_text; /**< the text of all Text cells */
+        };
+
+        /**
+         * @brief Format a stored cell for a column, without padding.
+         * @details The cell is formatted exactly as the original value would have been by CellFormatter::Format.
+         * @return A view of the text, valid until the next call to the formatter or until number is reused.
+         */
+        inline std::string_view FormatStoredCell(CellFormatter&    formatter,
+                                                 NumberBuffer&     number,
+                                                 const RowStore&   store,
+                                                 const StoredCell&   cell,
+                                                 int                 width,
+                                                 const NumberFormat& format = NumberFormat()) {
+
+            switch (cell.kind) {
+                case StoredCell::Kind::Text:
+                    return store.Text(cell);
+                case StoredCell::Kind::Integer:
+                    return formatter.Format(number, cell.integer, width, format);
+                case StoredCell::Kind::Unsigned:
+                    return formatter.Format(number, cell.unsignedInteger, width, format);
+                case StoredCell::Kind::Float:
+                    return formatter.Format(number, static_cast<float>(cell.floating), width, format);
+                case StoredCell::Kind::Double:
+                    return formatter.Format(number, cell.floating, width, format);
+            }
+            return {};
+        }
+
+        /**
+         * @brief Format a stored cell and append it to a buffer, padded to the column width.
+         */
+        inline void AppendStoredCell(CellFormatter&    formatter,
+                                     std::string&      buffer,
+                                     const RowStore&   store,
+                                     const StoredCell& cell,
+                                     int               width,
+                                     bool              flushLeft) {
+
+            NumberBuffer number;
+            AppendPadded(buffer, FormatStoredCell(formatter, number, store, cell, width), width, flushLeft);
+        }
+
+        /**
+         * @brief Format a stored cell for a delimited output: numbers in their shortest round-trip form, whatever
+         * the width and number format of the column.
+         * @return A view of the text, valid until number is reused.
+         */
+        inline std::string_view FormatStoredPlain(NumberBuffer& number, const RowStore& store, const StoredCell& cell) {
+
+            switch (cell.kind) {
+                case StoredCell::Kind::Text:
+                    return store.Text(cell);
+                case StoredCell::Kind::Integer:
+                    return FormatShortest(number, cell.integer);
+                case StoredCell::Kind::Unsigned:
+                    return FormatShortest(number, cell.unsignedInteger);
+                case StoredCell::Kind::Float:
+                    return FormatShortest(number, static_cast<float>(cell.floating));
+                case StoredCell::Kind::Double:
+                    return FormatShortest(number, cell.floating);
+            }
+            return {};
+        }
+
+        /**
+         * @brief Get the value of a stored number as a double.
+         * @param cell The cell.
+         * @param value Set to the value, if the cell holds a number.
+         * @return true if the cell holds a number.
+         */
+        inline bool StoredNumber(const StoredCell& cell, double& value) {
+
+            switch (cell.kind) {
+                case StoredCell::Kind::Text:
+                    return false;
+                case StoredCell::Kind::Integer:
+                    value = static_cast<double>(cell.integer);
+                    return true;
+                case StoredCell::Kind::Unsigned:
+                    value = static_cast<double>(cell.unsignedInteger);
+                    return true;
+                default:
+                    value = cell.floating;
+                    return true;
+            }
+        }
+
+        /**
+         * @brief Get the group a stored cell is sorted in: numbers (0), then text (1), then blanks and NaN (2).
+         * @details The groups keep their order when a column is sorted in descending order, so blanks always sort
+         * last.
+         */
+        inline int SortGroup(const StoredCell& cell) {
+
+            switch (cell.kind) {
+                case StoredCell::Kind::Text:
+                    return cell.length == 0 ? 2 : 1;
+                case StoredCell::Kind::Float:
+                case StoredCell::Kind::Double:
+                    return std::isnan(cell.floating) ? 2 : 0;
+                default:
+                    return 0;
+            }
+        }
+
+        /**
+         * @brief Compare two stored cells of the same sort group.
+         * @details Text is only compared with text; a blank text cell and a NaN share a group and compare equal.
+         * @return A negative number if a sorts before b, a positive number if after, or zero if they are equal.
+         */
+        inline int CompareStoredCells(const RowStore& store, const StoredCell& a, const StoredCell& b) {
+
+            if (a.kind == StoredCell::Kind::Text && b.kind == StoredCell::Kind::Text)
+                return store.Text(a).compare(store.Text(b));
+            if (a.kind == StoredCell::Kind::Text || b.kind == StoredCell::Kind::Text) return 0;
+            if (a.kind == StoredCell::Kind::Integer && b.kind == StoredCell::Kind::Integer)
+                return (a.integer > b.integer) - (a.integer < b.integer);
+            if (a.kind == StoredCell::Kind::Unsigned && b.kind == StoredCell::Kind::Unsigned)
+                return (a.unsignedInteger > b.unsignedInteger) - (a.unsignedInteger < b.unsignedInteger);
+
+            double x = 0.0;
+            double y = 0.0;
+            StoredNumber(a, x);
+            StoredNumber(b, y);
+            return (x > y) - (x < y);
+        }
+
+        /**
+         * @brief Estimates a percentile of a stream of values in constant memory, with the P-square algorithm of
+         * Jain and Chlamtac: five markers track the minimum, the maximum, the percentile and two points halfway,
+         * and are moved along a piecewise parabolic fit of the distribution as values arrive.
+         */
+        class P2Quantile {
+        public:
+
+            /**
+             * @brief Constructor.
+             * @param probability The percentile as a fraction, in [0, 1].
+             */
+            explicit P2Quantile(double probability)
+                    : m_probability(probability),
+                      m_increments{0, probability / 2, probability, (1 + probability) / 2, 1} {}
+
+            /**
+             * @brief Add a value.
+             */
+            void Add(double value) {
+
+                if (m_count < 5) {
+                    m_heights[m_count++] = value;
+                    if (m_count == 5) {
+                        std::sort(m_heights.begin(), m_heights.end());
+                        for (int i = 0; i < 5; ++i) m_positions[i] = i + 1;
+                        m_desired = {1, 1 + 2 * m_probability, 1 + 4 * m_probability, 3 + 2 * m_probability, 5};
+                    }
+                    return;
+                }
+
+                int cell = 0;
+                if (value < m_heights[0]) {
+                    m_heights[0] = value;
+                }
+                else if (value >= m_heights[4]) {
+                    m_heights[4] = value;
+                    cell         = 3;
+                }
+                else {
+                    while (value >= m_heights[cell + 1]) ++cell;
+                }
+
+                for (int i = cell + 1; i < 5; ++i) ++m_positions[i];
+                for (int i = 0; i < 5; ++i) m_desired[i] += m_increments[i];
+
+                for (int i = 1; i < 4; ++i) {
+                    auto offset = m_desired[i] - m_positions[i];
+                    if ((offset >= 1 && m_positions[i + 1] - m_positions[i] > 1) || (offset <= -1 && m_positions[i - 1] - m_positions[i] < -1)) {
+                        int  step   = offset > 0 ? 1 : -1;
+                        auto height = Parabolic(i, step);
+                        m_heights[i] = m_heights[i - 1] < height && height < m_heights[i + 1] ? height : Linear(i, step);
+                        m_positions[i] += step;
+                    }
+                }
+                ++m_count;
+            }
+
+            /**
+             * @brief Get the estimate; exact for up to five values, before the markers have been moved.
+             * @return The estimate, or NaN if no values have been added.
+             */
+            double Value() const {
+
+                if (m_count == 0) return std::nan("");
+                if (m_count > 5) return m_heights[2];
+
+                auto heights = m_heights;
+                std::sort(heights.begin(), heights.begin() + m_count);
+                return heights[static_cast<std::size_t>(std::lround(m_probability * (m_count - 1)))];
+            }
+
+            /**
+             * @brief Get the percentile as a fraction.
+             */
+            double Probability() const {
+
+                return m_probability;
+            }
+
+            /**
+             * @brief Forget all values.
+             */
+            void Clear() {
+
+                m_count = 0;
+            }
+
+        private:
+
+            double Parabolic(int i, int step) const {
+
+                const auto& n = m_positions;
+                const auto& q = m_heights;
+                return q[i] + step / (n[i + 1] - n[i - 1]) *
+                                      ((n[i] - n[i - 1] + step) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+                                       (n[i + 1] - n[i] - step) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+            }
+
+            double Linear(int i, int step) const {
+
+                return m_heights[i] + step * (m_heights[i + step] - m_heights[i]) / (m_positions[i + step] - m_positions[i]);
+            }
+
+            double                m_probability; /**< the percentile as a fraction */
+            std::array<double, 5> m_heights{}; /**< the marker heights; the first values while there are fewer than five */
+            std::array<double, 5> m_positions{}; /**< the actual marker positions */
+            std::array<double, 5> m_desired{}; /**< the desired marker positions */
+            std::array<double, 5> m_increments; /**< the increments of the desired positions per value */
+            std::size_t           m_count{0}; /**< the number of values added */
+        };
+
+        /**
+         * @brief Running aggregates of the numbers in one column.
+         * @details The sum is compensated (Neumaier), so long columns of small values do not lose precision.
+         */
+        class ColumnAggregate {
+        public:
+
+            /**
+             * @brief Add a value.
+             * @param value The value.
+             * @param integral Was the value printed as an integer?
+             */
+            void Add(double value, bool integral) {
+
+                m_integral = m_integral && integral;
+                if (m_count == 0) {
+                    m_min = value;
+                    m_max = value;
+                }
+                else {
+                    m_min = std::min(m_min, value);
+                    m_max = std::max(m_max, value);
+                }
+                ++m_count;
+
+                auto sum = m_sum + value;
+                m_compensation += std::abs(m_sum) >= std::abs(value) ? (m_sum - sum) + value : (value - sum) + m_sum;
+                m_sum = sum;
+
+                for (auto& quantile : m_quantiles) quantile.Add(value);
+            }
+
+            /**
+             * @brief Track a percentile.
+             * @param probability The percentile as a fraction.
+             */
+            void AddQuantile(double probability) {
+
+                m_quantiles.emplace_back(probability);
+            }
+
+            /**
+             * @brief Forget all values; the tracked percentiles are kept.
+             */
+            void Clear() {
+
+                m_count        = 0;
+                m_sum          = 0;
+                m_compensation = 0;
+                m_integral     = true;
+                for (auto& quantile : m_quantiles) quantile.Clear();
+            }
+
+            /**
+             * @brief Request an aggregate, given as a bit.
+             */
+            void Request(unsigned kind) {
+
+                m_kinds |= kind;
+            }
+
+            /**
+             * @brief Get the requested aggregates, as a bit mask.
+             */
+            unsigned Kinds() const {
+
+                return m_kinds;
+            }
+
+            /**
+             * @brief Were all values integers, so that the sum, the minimum and the maximum are too?
+             */
+            bool Integral() const {
+
+                return m_integral;
+            }
+
+            /**
+             * @brief Get the number of values.
+             */
+            std::uint64_t Count() const {
+
+                return m_count;
+            }
+
+            /**
+             * @brief Get the sum of the values.
+             */
+            double Sum() const {
+
+                return m_sum + m_compensation;
+            }
+
+            /**
+             * @brief Get the smallest value.
+             */
+            double Min() const {
+
+                return m_min;
+            }
+
+            /**
+             * @brief Get the largest value.
+             */
+            double Max() const {
+
+                return m_max;
+            }
+
+            /**
+             * @brief Get the mean of the values.
+             */
+            double Mean() const {
+
+                return Sum() / static_cast<double>(m_count);
+            }
+
+            /**
+             * @brief Get the estimate of a tracked percentile.
+             * @return The estimate, or NaN if the percentile is not tracked or there are no values.
+             */
+            double Quantile(double probability) const {
+
+                for (const auto& quantile : m_quantiles)
+                    if (quantile.Probability() == probability) return quantile.Value();
+                return std::nan("");
+            }
+
+            /**
+             * @brief Does the column track the percentile?
+             */
+            bool HasQuantile(double probability) const {
+
+                return std::any_of(m_quantiles.begin(), m_quantiles.end(), [&](const P2Quantile& quantile) {
+                    return quantile.Probability() == probability;
+                });
+            }
+
+        private:
+            unsigned                m_kinds{0}; /**< the requested aggregates, as a bit mask of Aggregate values */
+            std::uint64_t           m_count{0}; /**< the number of values */
+            double                  m_sum{0}; /**< the sum of the values */
+            double                  m_compensation{0}; /**< the compensation of the sum for lost low order bits */
+            double                  m_min{0}; /**< the smallest value */
+            double                  m_max{0}; /**< the largest value */
+            bool                    m_integral{true}; /**< were all values integers? */
+            std::vector<P2Quantile> m_quantiles; /**< the percentile estimators */
+        };
+
+        /**
+         * @brief Get a formatter for the calling thread, for use outside of a printer.
+         * @return A reference to the formatter of the calling thread.
+         */
+        inline CellFormatter& ThreadFormatter() {
+
+            static thread_local CellFormatter formatter;
+            return formatter;
+        }
+
+        /**
+         * @brief Get the natural width of a stored cell, i.e. the width it needs to be shown in full.
+         * @details Numbers are measured in their shortest fixed notation, or as the number format of the column
+         * prints them.
+         */
+        inline int NaturalWidth(const RowStore& store, const StoredCell& cell, const NumberFormat& format = NumberFormat()) {
+
+            if (!format.IsDefault()) {
+                switch (cell.kind) {
+                    case StoredCell::Kind::Text:
+                        break;
+                    case StoredCell::Kind::Integer:
+                        return format.NaturalWidth(cell.integer);
+                    case StoredCell::Kind::Unsigned:
+                        return format.NaturalWidth(cell.unsignedInteger);
+                    case StoredCell::Kind::Float:
+                        return format.NaturalWidth(static_cast<float>(cell.floating));
+                    case StoredCell::Kind::Double:
+                        return format.NaturalWidth(cell.floating);
+                }
+            }
+
+            NumberBuffer buffer;
+            std::to_chars_result result{};
+            switch (cell.kind) {
+                case StoredCell::Kind::Text:
+                    return static_cast<int>(DisplayWidth(store.Text(cell)));
+                case StoredCell::Kind::Integer:
+                    return IntegerWidth(cell.integer);
+                case StoredCell::Kind::Unsigned:
+                    return IntegerWidth(cell.unsignedInteger);
+                case StoredCell::Kind::Float:
+                    result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), static_cast<float>(cell.floating), std::chars_format::fixed);
+                    break;
+                case StoredCell::Kind::Double:
+                    result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), cell.floating, std::chars_format::fixed);
+                    break;
+            }
+            return result.ec == std::errc() ? static_cast<int>(result.ptr - buffer.data()) : static_cast<int>(buffer.size());
+        }
+
+        /**
+         * @brief Append a horizontal border line to a buffer.
+         * @param buffer The buffer to append to.
+         * @param tableWidth The width of the table, as reported by GetTableWidth().
+         * @param character The character to draw the line with.
+         */
+        inline void AppendHorizontalLine(std::string& buffer, int tableWidth, char character) {
+
+            buffer += '+'; // the left bar
+            if (tableWidth > 1) buffer.append(static_cast<std::size_t>(tableWidth - 1), character);
+            buffer += "+\n"; // the right bar
+        }
+
+        /**
+         * @brief Append a title block (a double line followed by the centered title) to a buffer.
+         * @param buffer The buffer to append to.
+         * @param title The title. Titles wider than the table are cut.
+         * @param tableWidth The width of the table, as reported by GetTableWidth().
+         * @param innerWidth The width available for the title between the left and right borders.
+         */
+        inline void AppendTitle(std::string& buffer, std::string_view title, int tableWidth, int innerWidth) {
+
+            innerWidth = std::max(innerWidth, 0);
+            title      = TruncateToWidth(title, static_cast<std::size_t>(innerWidth));
+
+            auto titleWidth = DisplayWidth(title);
+            auto pre        = (innerWidth - titleWidth) / 2;
+            auto post       = (innerWidth - titleWidth - pre);
+
+            AppendHorizontalLine(buffer, tableWidth, '=');
+            buffer += '|';
+            buffer.append(pre, ' ');
+            buffer.append(title.data(), title.size());
+            buffer.append(post, ' ');
+            buffer += "|\n";
+        }
+
+        /**
+         * @brief Append a header block (the column titles between two double lines) to a buffer.
+         * @tparam Titles A random access container of strings.
+         * @tparam Widths A random access container of integers, with the same size as titles.
+         * @param buffer The buffer to append to.
+         * @param titles The column titles. Titles wider than their column are cut.
+         * @param widths The column widths.
+         * @param separator The column separator.
+         * @param tableWidth The width of the table, as reported by GetTableWidth().
+         * @param flushLeft If true, the titles are left aligned; otherwise they are right aligned.
+         */
+        template<typename Titles, typename Widths>
+        void AppendHeader(std::string&     buffer,
+                          const Titles&    titles,
+                          const Widths&    widths,
+                          std::string_view separator,
+                          int              tableWidth,
+                          bool             flushLeft) {
+
+            AppendHorizontalLine(buffer, tableWidth, '=');
+            buffer += '|';
+
+            for (std::size_t i = 0; i < titles.size(); ++i) {
+
+                AppendPadded(buffer, TruncateToWidth(titles[i], static_cast<std::size_t>(widths[i])), widths[i], flushLeft);
+                if (i != titles.size() - 1) {
+                    buffer.append(separator.data(), separator.size());
+                }
+            }
+
+            buffer += "|\n";
+            AppendHorizontalLine(buffer, tableWidth, '=');
+        }
+
+        /**
+         * @brief The escape sequence ending a styled cell.
+         */
+        constexpr std::string_view StyleReset = "\033[0m";
+
+        /**
+         * @brief Is the text a number in JSON syntax, so that it can be written without quotes? NaN and the
+         * infinities are not.
+         */
+        inline bool IsJsonNumber(std::string_view text) {
+
+            std::size_t pos    = 0;
+            auto        digits = [&]() {
+                auto start = pos;
+                while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') ++pos;
+                return pos > start;
+            };
+
+            if (pos < text.size() && text[pos] == '-') ++pos;
+            if (pos < text.size() && text[pos] == '0')
+                ++pos;
+            else if (!digits())
+                return false;
+            if (pos < text.size() && text[pos] == '.' && (++pos, !digits())) return false;
+            if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+                ++pos;
+                if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) ++pos;
+                if (!digits()) return false;
+            }
+            return pos == text.size();
+        }
+
+        /**
+         * @brief Append text to a buffer as a JSON string, in quotes.
+         */
+        inline void AppendJsonString(std::string& buffer, std::string_view text) {
+
+            static constexpr char hex[] = "0123456789abcdef";
+
+            buffer += '"';
+            std::size_t start = 0;
+            for (std::size_t pos = 0; pos < text.size(); ++pos) {
+                auto c = static_cast<unsigned char>(text[pos]);
+                if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+                buffer.append(text.data() + start, pos - start);
+                start = pos + 1;
+                switch (c) {
+                    case '"':
+                        buffer += "\\\"";
+                        break;
+                    case '\\':
+                        buffer += "\\\\";
+                        break;
+                    case '\n':
+                        buffer += "\\n";
+                        break;
+                    case '\r':
+                        buffer += "\\r";
+                        break;
+                    case '\t':
+                        buffer += "\\t";
+                        break;
+                    default:
+                        buffer += "\\u00";
+                        buffer += hex[c >> 4];
+                        buffer += hex[c & 0xf];
+                }
+            }
+            buffer.append(text.data() + start, text.size() - start);
+            buffer += '"';
+        }
+
+        /**
+         * @brief A set of characters, as a lookup table.
+         */
+        struct CharacterSet {
+            bool contains[256]; /**< is each character in the set? */
+        };
+
+        /**
+         * @brief Make a character set at compile time.
+         */
+        constexpr CharacterSet MakeCharacterSet(std::string_view characters) {
+
+            CharacterSet set{};
+            for (auto c : characters) set.contains[static_cast<unsigned char>(c)] = true;
+            return set;
+        }
+
+        /**
+         * @brief Is the format read by other programs? Numbers are written to these formats in full, in their
+         * shortest round-trip form, rather than fitted to the column width.
+         */
+        inline bool IsDelimited(OutputFormat format) {
+
+            return format == OutputFormat::Csv || format == OutputFormat::Tsv || format == OutputFormat::JsonLines;
+        }
+
+        /**
+         * @brief Escape the text of a cell for an output format.
+         * @details Text with nothing to escape (the common case, found by a single scan) is returned as it is;
+         * otherwise the escaped text is written to a scratch buffer of the calling thread, valid until the next call.
+         * @param format The output format.
+         * @param text The text of the cell.
+         * @param number Is the cell a number? Numbers are written to JSON without quotes, and text always in quotes.
+         * @return A view of the escaped text.
+         */
+        inline std::string_view EscapeCell(OutputFormat format, std::string_view text, bool number = false) {
+
+            static constexpr CharacterSet csv      = MakeCharacterSet(",\"\r\n");
+            static constexpr CharacterSet tsv      = MakeCharacterSet("\t\r\n\\");
+            static constexpr CharacterSet markdown = MakeCharacterSet("|\r\n");
+            static thread_local std::string scratch;
+
+            const CharacterSet* special = nullptr;
+            switch (format) {
+                case OutputFormat::Csv:
+                    special = &csv;
+                    break;
+                case OutputFormat::Tsv:
+                    special = &tsv;
+                    break;
+                case OutputFormat::Markdown:
+                    special = &markdown;
+                    break;
+                case OutputFormat::JsonLines:
+                    if (number && IsJsonNumber(text)) return text;
+                    scratch.clear();
+                    AppendJsonString(scratch, text);
+                    return scratch;
+                default:
+                    return text;
+            }
+
+            std::size_t pos = 0;
+            while (pos < text.size() && !special->contains[static_cast<unsigned char>(text[pos])]) ++pos;
+            if (pos == text.size()) return text;
+
+            scratch.clear();
+            if (format == OutputFormat::Csv) scratch += '"';
+            scratch.append(text.data(), pos);
+            for (; pos < text.size(); ++pos) {
+                auto c = text[pos];
+                if (format == OutputFormat::Csv) {
+                    if (c == '"') scratch += '"';
+                    scratch += c;
+                }
+                else if (format == OutputFormat::Tsv) {
+                    scratch += c == '\t' ? "\\t" : c == '\r' ? "\\r" : c == '\n' ? "\\n" : c == '\\' ? "\\\\" : std::string_view(&text[pos], 1);
+                }
+                else {
+                    scratch += c == '|' ? "\\|" : c == '\n' ? "<br>" : c == '\r' ? "" : std::string_view(&text[pos], 1);
+                }
+            }
+            if (format == OutputFormat::Csv) scratch += '"';
+            return scratch;
+        }
+
+        /**
+         * @brief The physical lines of a row being written into a buffer, by a RowSkeleton.
+         * @details A row has one line, unless a wrapped cell needs more. The lines are kept at the end of the buffer.
+         */
+        class RowBlock {
+        public:
+
+            /**
+             * @brief A physical line of the row.
+             */
+            struct Line {
+                std::size_t start; /**< the offset of the line in the buffer */
+                std::size_t shift; /**< how far the cells of the line have been moved from their slots */
+            };
+
+            /**
+             * @brief Start a new row, with a line at the given offset.
+             */
+            void Reset(std::size_t start) {
+
+                m_lines.clear();
+                m_lines.push_back({start, 0});
+            }
+
+            /**
+             * @brief Add a line at the given offset.
+             */
+            void AddLine(std::size_t start) {
+
+                m_lines.push_back({start, 0});
+            }
+
+            /**
+             * @brief Get the number of lines.
+             */
+            std::size_t LineCount() const {
+
+                return m_lines.size();
+            }
+
+            /**
+             * @brief Get a line.
+             */
+            Line& operator[](std::size_t line) {
+
+                return m_lines[line];
+            }
+
+            /**
+             * @brief Record that a line has grown, moving the lines after it.
+             */
+            void Grow(std::size_t line, std::size_t count) {
+
+                for (auto i = line + 1; i < m_lines.size(); ++i) m_lines[i].start += count;
+            }
+
+        private:
+            std::vector<Line> m_lines; /**< the lines of the row */
+        };
+
+        /**
+         * @brief The layout of a table compiled into text: a blank row, with the offset of each cell in it, and the
+         * border lines and header block.
+         * @details A row is rendered by appending the blank row and writing the text of each cell into its slot,
+         * so the borders, separators and padding are copied in one go rather than cell by cell. A cell wider than
+         * its column is not cut; it pushes the rest of the row to the right, as in padded output, unless the
+         * column wraps: then the cell is broken into lines at word boundaries, and the row gets as many lines
+         * as its longest cell.
+         *
+         * The other output formats are compiled the same way: a CSV row is a row of empty slots between commas,
+         * a JSON Lines row has the keys in it, and so on. Their cells are escaped when written, and never wrapped
+         * or styled.
+         */
+        class RowSkeleton {
+        public:
+
+            /**
+             * @brief Compile a layout.
+             * @tparam Titles A random access container of strings.
+             * @tparam Widths A random access container of integers, with the same size as titles.
+             * @param titles The column titles.
+             * @param widths The column widths.
+             * @param separator The column separator.
+             * @param flushLeft If true, the cells are left aligned; otherwise they are right aligned.
+             * @param wrap For each column, whether long cells are wrapped; missing columns are not.
+             * @param format The output format. The separator is only used by the boxed format.
+             * @param alignment For each column, '<' to align its cells left, '>' to align them right, or 0 to align
+             * them as given by flushLeft; missing columns are aligned as given by flushLeft.
+             */
+            template<typename Titles, typename Widths>
+            void Build(const Titles&            titles,
+                       const Widths&            widths,
+                       std::string_view         separator,
+                       bool                     flushLeft,
+                       const std::vector<char>& wrap      = {},
+                       OutputFormat             format    = OutputFormat::Boxed,
+                       const std::vector<char>& alignment = {}) {
+
+                m_format = format;
+                m_widths.assign(std::begin(widths), std::end(widths));
+                m_left.assign(m_widths.size(), flushLeft);
+                for (std::size_t column = 0; column < std::min(alignment.size(), m_left.size()); ++column) {
+                    if (alignment[column] != 0) m_left[column] = alignment[column] == '<';
+                }
+                m_wrap.assign(m_widths.size(), 0);
+                if (format == OutputFormat::Boxed) std::copy_n(wrap.begin(), std::min(wrap.size(), m_wrap.size()), m_wrap.begin());
+                m_anyWrap = std::find(m_wrap.begin(), m_wrap.end(), 1) != m_wrap.end();
+                m_offsets.clear();
+                m_row.clear();
+
+                // Delimited formats are not padded, so their slots are empty.
+                m_slots.assign(m_widths.size(), 0);
+                if (format == OutputFormat::Boxed || format == OutputFormat::Markdown) m_slots = m_widths;
+
+                auto separatorWidth = static_cast<int>(DisplayWidth(separator));
+                int  tableWidth     = 0;
+                for (auto width : m_widths) tableWidth += width + separatorWidth;
+
+                std::string_view open  = "|";
+                std::string_view close = "|\n";
+                switch (format) {
+                    case OutputFormat::Markdown:
+                        open = "| ", separator = " | ", close = " |\n";
+                        break;
+                    case OutputFormat::Csv:
+                        open = "", separator = ",", close = "\n";
+                        break;
+                    case OutputFormat::Tsv:
+                        open = "", separator = "\t", close = "\n";
+                        break;
+                    case OutputFormat::JsonLines:
+                        open = "{", separator = ",", close = "}\n";
+                        break;
+                    default:
+                        break;
+                }
+
+                m_positions.clear();
+                m_row += open;
+                int position = 1;
+                for (std::size_t column = 0; column < m_widths.size(); ++column) {
+                    if (format == OutputFormat::JsonLines) {
+                        AppendJsonString(m_row, std::string_view(titles[column]));
+                        m_row += ':';
+                    }
+                    m_offsets.push_back(m_row.size());
+                    m_positions.push_back(static_cast<std::size_t>(position));
+                    m_row.append(static_cast<std::size_t>(m_slots[column]), ' ');
+                    m_row += column + 1 < m_widths.size() ? separator : close;
+                    position += m_widths[column] + separatorWidth;
+                }
+
+                m_line.clear();
+                m_divider.clear();
+                m_header.clear();
+                switch (format) {
+                    case OutputFormat::Boxed:
+                        AppendHorizontalLine(m_line, tableWidth, '-');
+                        m_divider = m_line;
+                        AppendHeader(m_header, titles, m_widths, separator, tableWidth, flushLeft);
+                        break;
+                    case OutputFormat::JsonLines:
+                        break;
+                    default: {
+                        // The titles, as a row of their own.
+                        RowBlock block;
+                        Open(m_header, block);
+                        for (std::size_t column = 0; column < m_widths.size(); ++column) Fill(m_header, block, column, titles[column]);
+                        if (format == OutputFormat::Markdown) {
+                            m_header += '|';
+                            for (std::size_t column = 0; column < m_widths.size(); ++column) {
+                                if (m_left[column]) m_header += ':';
+                                m_header.append(static_cast<std::size_t>(m_widths[column]) + 1, '-');
+                                if (!m_left[column]) m_header += ':';
+                                m_header += '|';
+                            }
+                            m_header += '\n';
+                            m_line = "\n";
+                        }
+                        break;
+                    }
+                }
+            }
+
+            /**
+             * @brief Append a blank row to a buffer, to be filled by Fill.
+             * @param buffer The buffer to append to.
+             * @param block Keeps track of the lines of the row.
+             */
+            void Open(std::string& buffer, RowBlock& block) const {
+
+                block.Reset(buffer.size());
+                buffer.append(m_row);
+            }
+
+            /**
+             * @brief Write the text of a cell into its slot in the row opened last.
+             * @param buffer The buffer holding the row, at its end.
+             * @param block The lines of the row, as set up by Open.
+             * @param column The column index.
+             * @param text The text of the cell. Wrapped cells are written from views into it.
+             * @param style An escape sequence to put in front of the cell, or nothing. A styled cell is followed by
+             * a reset sequence. Neither counts towards the width of the cell.
+             * @param number Is the cell a number? This decides the quoting of JSON cells.
+             */
+            void Fill(std::string&     buffer,
+                      RowBlock&        block,
+                      std::size_t      column,
+                      std::string_view text,
+                      std::string_view style  = {},
+                      bool             number = false) const {
+
+                if (m_format != OutputFormat::Boxed) {
+                    text = EscapeCell(m_format, text, number);
+                    if (m_slots[column] != 0) {
+                        FillLine(buffer, block, 0, column, text, {});
+                        return;
+                    }
+
+                    // An empty slot of a delimited format: the text goes in as it is.
+                    auto& shift = block[0].shift;
+                    buffer.insert(block[0].start + shift + m_offsets[column], text.data(), text.size());
+                    shift += text.size();
+                    return;
+                }
+
+                auto width = static_cast<std::size_t>(m_widths[column]);
+                if (!m_anyWrap || !m_wrap[column] || (DisplayWidth(text) <= width && text.find('\n') == std::string_view::npos)) {
+                    FillLine(buffer, block, 0, column, text, style);
+                    return;
+                }
+
+                for (std::size_t line = 0; !text.empty(); ++line) {
+                    auto piece = NextWrappedLine(text, width);
+                    if (line == block.LineCount()) {
+                        block.AddLine(buffer.size());
+                        buffer.append(m_row);
+                    }
+                    FillLine(buffer, block, line, column, piece, style);
+                }
+            }
+
+            /**
+             * @brief Get the screen column of a cell, counted from zero, within a row with no overflowing cells.
+             */
+            std::size_t Position(std::size_t column) const {
+
+                return m_positions[column];
+            }
+
+            /**
+             * @brief Get the column widths.
+             */
+            const std::vector<int>& Widths() const {
+
+                return m_widths;
+            }
+
+            /**
+             * @brief Are the cells of a column wrapped onto several lines?
+             */
+            bool Wraps(std::size_t column) const {
+
+                return m_wrap[column] != 0;
+            }
+
+            /**
+             * @brief Is the format delimited, so that numbers are written in full? See detail::IsDelimited.
+             */
+            bool Delimited() const {
+
+                return IsDelimited(m_format);
+            }
+
+            /**
+             * @brief Get the number of columns.
+             */
+            std::size_t ColumnCount() const {
+
+                return m_widths.size();
+            }
+
+            /**
+             * @brief Get the horizontal line ending a table.
+             */
+            const std::string& Line() const {
+
+                return m_line;
+            }
+
+            /**
+             * @brief Get the header block: the column titles between two double lines.
+             */
+            const std::string& Header() const {
+
+                return m_header;
+            }
+
+            /**
+             * @brief Get the line between the rows of a table and its summary rows; empty if the format has none.
+             */
+            const std::string& Divider() const {
+
+                return m_divider;
+            }
+
+            /**
+             * @brief Append a title block to a buffer. Only the boxed and Markdown formats have titles.
+             * @param buffer The buffer to append to.
+             * @param title The title.
+             * @param tableWidth The width of the table.
+             * @param innerWidth The width of the title block between its borders.
+             */
+            void AppendTitleBlock(std::string& buffer, std::string_view title, int tableWidth, int innerWidth) const {
+
+                if (m_format == OutputFormat::Boxed) {
+                    AppendTitle(buffer, title, tableWidth, innerWidth);
+                }
+                else if (m_format == OutputFormat::Markdown) {
+                    buffer += "**";
+                    buffer += EscapeCell(m_format, title);
+                    buffer += "**\n\n";
+                }
+            }
+
+        private:
+
+            /**
+             * @brief Write text into a slot on one line of a row.
+             */
+            void FillLine(std::string&     buffer,
+                          RowBlock&        block,
+                          std::size_t      line,
+                          std::size_t      column,
+                          std::string_view text,
+                          std::string_view style) const {
+
+                auto& shift   = block[line].shift;
+                auto  before  = shift;
+                auto  start   = block[line].start + shift + m_offsets[column];
+                auto  width   = static_cast<std::size_t>(m_slots[column]);
+                auto  columns = DisplayWidth(text);
+                if (columns == text.size() && columns <= width) {
+                    auto position = m_left[column] ? start : start + width - text.size();
+                    std::copy(text.begin(), text.end(), buffer.begin() + static_cast<std::ptrdiff_t>(position));
+                }
+                else {
+                    // Multi-byte and overflowing text takes more bytes than the slot has; keep the padding it
+                    // needs, and replace the other spaces with the text.
+                    auto padding  = columns < width ? width - columns : 0;
+                    auto position = m_left[column] ? start : start + padding;
+                    buffer.replace(position, width - padding, text.data(), text.size());
+                    shift += text.size() - (width - padding);
+                    width = padding + text.size();
+                }
+
+                if (!style.empty()) {
+                    buffer.insert(start + width, StyleReset);
+                    buffer.insert(start, style.data(), style.size());
+                    shift += style.size() + StyleReset.size();
+                }
+
+                block.Grow(line, shift - before);
+            }
+
+            std::vector<int>         m_widths; /**< the column widths */
+            std::vector<int>         m_slots; /**< the width of the slot of each cell in the blank row */
+            std::vector<char>        m_wrap; /**< are the cells of each column wrapped? */
+            std::vector<std::size_t> m_offsets; /**< the offset of each cell in the blank row */
+            std::vector<std::size_t> m_positions; /**< the screen column of each cell */
+            std::string              m_row; /**< a blank row */
+            std::string              m_line; /**< the horizontal line ending a table */
+            std::string              m_divider; /**< the line before the summary rows */
+            std::string              m_header; /**< the header block */
+            OutputFormat             m_format{OutputFormat::Boxed}; /**< the output format */
+            std::vector<char>        m_left; /**< are the cells of each column left aligned? */
+            bool                     m_anyWrap{false}; /**< are any columns wrapped? */
+        };
+
+        /**
+         * @brief The style rules of a table, with their escape sequences compiled in advance.
+         * @details Each column has a list of rules; the first rule matching a cell decides its style. Numbers are
+         * matched by the threshold and number rules, and everything else by the text rules. When row shading is
+         * set, cells in every second row of a table get the shading, combined with the style of a matching rule.
+         */
+        class StyleSheet {
+        public:
+
+            /**
+             * @brief A style rule for the cells of one column.
+             */
+            struct Rule {
+                enum class Kind { Above, Below, Number, Text };
+
+                Kind                                   kind; /**< how the cells are matched */
+                double                                 threshold; /**< the threshold for Above and Below */
+                std::function<bool(double)>            number; /**< the predicate for Number */
+                std::function<bool(std::string_view)>  text; /**< the predicate for Text */
+                std::string                            style; /**< the escape sequence of matching cells */
+                std::string                            shadedStyle{}; /**< the same, combined with the row shading */
+            };
+
+            /**
+             * @brief Add a rule for a column, after the existing rules of the column.
+             */
+            void Add(std::size_t column, Rule rule) {
+
+                if (m_rules.size() <= column) m_rules.resize(column + 1);
+                rule.shadedStyle = m_shading + rule.style;
+                m_rules[column].push_back(std::move(rule));
+            }
+
+            /**
+             * @brief Set the escape sequence for every second row; empty for none.
+             */
+            void SetShading(std::string shading) {
+
+                m_shading = std::move(shading);
+                for (auto& rules : m_rules)
+                    for (auto& rule : rules) rule.shadedStyle = m_shading + rule.style;
+            }
+
+            /**
+             * @brief Remove all rules and the row shading.
+             */
+            void Clear() {
+
+                m_rules.clear();
+                m_shading.clear();
+            }
+
+            /**
+             * @brief Are there no rules and no shading?
+             */
+            bool Empty() const {
+
+                return m_rules.empty() && m_shading.empty();
+            }
+
+            /**
+             * @brief Select the style of a cell.
+             * @tparam T The type of the value.
+             * @param column The column index.
+             * @param row The index of the row within the table.
+             * @param value The value of the cell.
+             * @param text The formatted text of the cell.
+             * @return The escape sequence, or nothing if the cell is not styled.
+             */
+            template<typename T>
+            std::string_view Select(std::size_t column, std::size_t row, const T& value, std::string_view text) const {
+
+                if constexpr(IsStoredAsInteger<T> || std::is_floating_point<T>::value)
+                    return SelectNumber(column, row, static_cast<double>(value));
+                else
+                    return SelectText(column, row, text);
+            }
+
+            /**
+             * @brief Select the style of a stored cell.
+             */
+            std::string_view SelectStored(std::size_t column, std::size_t row, const StoredCell& cell, std::string_view text) const {
+
+                switch (cell.kind) {
+                    case StoredCell::Kind::Text:
+                        return SelectText(column, row, text);
+                    case StoredCell::Kind::Integer:
+                        return SelectNumber(column, row, static_cast<double>(cell.integer));
+                    case StoredCell::Kind::Unsigned:
+                        return SelectNumber(column, row, static_cast<double>(cell.unsignedInteger));
+                    default:
+                        return SelectNumber(column, row, cell.floating);
+                }
+            }
+
+        private:
+
+            std::string_view SelectNumber(std::size_t column, std::size_t row, double value) const {
+
+                auto shaded = IsShaded(row);
+                if (column < m_rules.size()) {
+                    for (const auto& rule : m_rules[column]) {
+                        bool match = false;
+                        switch (rule.kind) {
+                            case Rule::Kind::Above:
+                                match = value > rule.threshold;
+                                break;
+                            case Rule::Kind::Below:
+                                match = value < rule.threshold;
+                                break;
+                            case Rule::Kind::Number:
+                                match = rule.number(value);
+                                break;
+                            case Rule::Kind::Text:
+                                break;
+                        }
+                        if (match) return shaded ? rule.shadedStyle : rule.style;
+                    }
+                }
+                return shaded ? std::string_view(m_shading) : std::string_view();
+            }
+
+            std::string_view SelectText(std::size_t column, std::size_t row, std::string_view text) const {
+
+                auto shaded = IsShaded(row);
+                if (column < m_rules.size()) {
+                    for (const auto& rule : m_rules[column]) {
+                        if (rule.kind == Rule::Kind::Text && rule.text(text)) return shaded ? rule.shadedStyle : rule.style;
+                    }
+                }
+                return shaded ? std::string_view(m_shading) : std::string_view();
+            }
+
+            bool IsShaded(std::size_t row) const {
+
+                return !m_shading.empty() && row % 2 == 1;
+            }
+
+            std::vector<std::vector<Rule>> m_rules; /**< the rules of each column */
+            std::string                    m_shading; /**< the escape sequence for every second row */
+        };
+
+        /**
+         * @brief Count a printed cell in the statistics of its column.
+         * @param statistics The statistics of the column.
+         * @param text The text of the cell.
+         * @param width The column width.
+         * @param number Is the cell a number?
+         * @param wrapped Is the column wrapped? Wrapped cells never overflow.
+         * @param marker The overflow marker of the column.
+         */
+        inline void CountCell(TableStatistics::Column& statistics, std::string_view text, int width, bool number, bool wrapped, char marker) {
+
+            ++statistics.cells;
+            if (number && !text.empty() && text.back() == marker)
+                ++statistics.truncated;
+            else if (!number && !wrapped && DisplayWidth(text) > static_cast<std::size_t>(width))
+                ++statistics.overflowed;
+        }
+
+        /**
+         * @brief Format the stored rows [first, last) and append them to a buffer.
+         * @details Only the formatter and the buffer are modified, so several threads can render different rows of
+         * the same store concurrently, each with its own formatter and buffer.
+         * @param block Scratch space for the lines of a row.
+         * @param order The index in the store of each row to print, for printing the rows in another order;
+         * nullptr to print the rows in the order stored.
+         * @param formats The number format of each column.
+         * @param styles The style rules, or nullptr for unstyled output.
+         * @param tableRow The index within the table of the first row, for row shading.
+         * @param statistics The statistics of each column, to count the cells in; nullptr for none.
+         */
+        inline void AppendStoredRows(CellFormatter&     formatter,
+                                     std::string&       buffer,
+                                     RowBlock&          block,
+                                     const RowStore&    store,
+                                     std::size_t        first,
+                                     std::size_t        last,
+                                     const std::size_t* order,
+                                     const RowSkeleton&               skeleton,
+                                     const std::vector<NumberFormat>& formats,
+                                     const StyleSheet*                styles,
+                                     std::size_t                      tableRow,
+                                     std::vector<TableStatistics::Column>* statistics = nullptr) {
+
+            NumberBuffer number;
+            const auto&  widths      = skeleton.Widths();
+            auto         columnCount = skeleton.ColumnCount();
+            for (auto row = first; row < last; ++row, ++tableRow) {
+                const auto* cells = store.Row(order ? order[row] : row, columnCount);
+                skeleton.Open(buffer, block);
+                for (std::size_t column = 0; column < columnCount; ++column) {
+                    auto isNumber = cells[column].kind != StoredCell::Kind::Text;
+                    auto text     = skeleton.Delimited() ? FormatStoredPlain(number, store, cells[column])
+                                                         : FormatStoredCell(formatter, number, store, cells[column], widths[column], formats[column]);
+                    if constexpr(StatisticsEnabled) {
+                        if (statistics) CountCell((*statistics)[column], text, widths[column], isNumber, skeleton.Wraps(column), formats[column].Marker());
+                    }
+                    auto style = styles ? styles->SelectStored(column, tableRow, cells[column], text) : std::string_view();
+                    skeleton.Fill(buffer, block, column, text, style, isNumber);
+                }
+            }
+        }
+
+        /**
+         * @brief The type a StaticTablePrinter takes the values of a column of type T as: by const reference,
+         * except for strings, which are taken as views, so that string literals and views are not copied into a
+         * temporary std::string for every row.
+         */
+        template<typename T>
+        struct ColumnParameter {
+            using type = const T&; /**< the parameter type */
+        };
+
+        /**
+         * @brief Strings are taken as views; see ColumnParameter.
+         */
+        template<>
+        struct ColumnParameter<std::string> {
+            using type = std::string_view; /**< the parameter type */
+        };
+    } // namespace detail
+
+    /**
+     * @brief The destination of the text produced by a printer.
+     * @details Printers hand their output to the sink in blocks of whole lines: a row, a border, a header block,
+     * or (in the batch modes) many rows at once.
+     */
+    class Sink {
+    public:
+
+        /**
+         * @brief Destructor.
+         */
+        virtual ~Sink() = default;
+
+        /**
+         * @brief Write a block of text.
+         * @param data A pointer to the text.
+         * @param size The number of characters.
+         */
+        virtual void Write(const char* data, std::size_t size) = 0;
+
+        /**
+         * @brief Pass any buffered text on to its final destination.
+         */
+        virtual void Flush() = 0;
+    };
+
+    /**
+     * @brief A sink writing to a std::ostream. This is what printers constructed with a stream use.
+     */
+    class StreamSink : public Sink {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param output The stream to write to.
+         */
+        explicit StreamSink(std::ostream& output)
+                : m_outStream(output) {
+
+        }
+
+        /**
+         * @brief Get the stream written to.
+         * @return A reference to the stream.
+         */
+        std::ostream& GetStream() const {
+
+            return m_outStream;
+        }
+
+        void Write(const char* data, std::size_t size) override {
+
+            m_outStream.write(data, static_cast<std::streamsize>(size));
+        }
+
+        void Flush() override {
+
+            m_outStream.flush();
+        }
+
+    private:
+        std::ostream& m_outStream; /**< */
+    };
+
+    /**
+     * @brief What an AsyncSink does when its buffer is full.
+     */
+    enum class BackpressurePolicy {
+        Block, /**< wait until the writer thread has made room */
+        Drop, /**< discard the block of text (typically a row), and count it */
+        Grow /**< enlarge the buffer */
+    };
+
+    /**
+     * @brief A sink that hands text to a background thread, which writes it to another sink.
+     *
+     * Usage:
+     *   trl::AsyncSink sink(std::cout, 1 << 20, trl::BackpressurePolicy::Drop);
+     *   trl::TablePrinter tp(sink);
+     *
+     * Writes copy the text into a bounded ring buffer and return; the writer thread drains the buffer into the
+     * downstream sink, so a slow terminal or pipe does not stall the printing thread. What happens when the
+     * buffer is full is decided by the BackpressurePolicy. Flush() waits until everything written so far has
+     * been passed on, and flushes the downstream sink. The destructor drains the buffer. The sink may be shared
+     * by several printers on different threads; each write is kept in one piece. Under BackpressurePolicy::Block,
+     * a write larger than the whole buffer is passed on in several pieces, and other writes wait until it is done.
+     */
+    class AsyncSink : public Sink {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param downstream The sink to write to from the background thread.
+         * @param capacity The size of the ring buffer, in bytes.
+         * @param policy What to do when the ring buffer is full.
+         */
+        explicit AsyncSink(Sink& downstream, std::size_t capacity = 1 << 20, BackpressurePolicy policy = BackpressurePolicy::Block)
+                : m_downstream(downstream),
+                  m_ring(std::max<std::size_t>(capacity, 1)),
+                  m_policy(policy) {
+
+            m_writer = std::thread([this] { WriterLoop(); });
+        }
+
+        /**
+         * @brief Constructor.
+         * @param output The stream to write to from the background thread.
+         * @param capacity The size of the ring buffer, in bytes.
+         * @param policy What to do when the ring buffer is full.
+         */
+        explicit AsyncSink(std::ostream& output, std::size_t capacity = 1 << 20, BackpressurePolicy policy = BackpressurePolicy::Block)
+                : m_ownedSink(std::make_unique<StreamSink>(output)),
+                  m_downstream(*m_ownedSink),
+                  m_ring(std::max<std::size_t>(capacity, 1)),
+                  m_policy(policy) {
+
+            m_writer = std::thread([this] { WriterLoop(); });
+        }
+
+        /**
+         * @brief
+         * @param other
+         */
+        AsyncSink(const AsyncSink& other) = delete;
+
+        /**
+         * @brief
+         * @param other
+         * @return
+         */
+        AsyncSink& operator=(const AsyncSink& other) = delete;
+
+        /**
+         * @brief Destructor. Writes everything still buffered, and stops the background thread.
+         */
+        ~AsyncSink() override {
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_dataAvailable.notify_one();
+            m_writer.join();
+        }
+
+        void Write(const char* data, std::size_t size) override {
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_spaceAvailable.wait(lock, [&] { return !m_splitting || m_error; });
+            ThrowPendingError();
+
+            if (m_policy != BackpressurePolicy::Block || size <= m_ring.size()) {
+                CopyInWhenRoom(lock, data, size);
+                return;
+            }
+
+            // The block does not fit in the buffer, so it is passed on in pieces, keeping other writes out meanwhile.
+            m_splitting = true;
+            try {
+                CopyInWhenRoom(lock, data, size);
+            }
+            catch (...) {
+                m_splitting = false;
+                m_spaceAvailable.notify_all();
+                throw;
+            }
+            m_splitting = false;
+            m_spaceAvailable.notify_all();
+        }
+
+        void Flush() override {
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto                         request = ++m_flushRequested;
+            m_flushTarget                        = m_head;
+            m_dataAvailable.notify_one();
+            m_flushDone.wait(lock, [&] { return m_flushCompleted >= request; });
+            ThrowPendingError();
+        }
+
+        /**
+         * @brief Get the number of writes discarded because the buffer was full (with BackpressurePolicy::Drop).
+         * @return The number of discarded writes.
+         */
+        std::uint64_t GetDroppedWrites() const {
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_droppedWrites;
+        }
+
+        /**
+         * @brief Get the number of bytes discarded because the buffer was full (with BackpressurePolicy::Drop).
+         * @return The number of discarded bytes.
+         */
+        std::uint64_t GetDroppedBytes() const {
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_droppedBytes;
+        }
+
+    private:
+
+        /**
+         * @brief Copy a block of text into the ring buffer, applying the backpressure policy when it is full.
+         * @param lock The lock on the mutex, held by the caller.
+         */
+        void CopyInWhenRoom(std::unique_lock<std::mutex>& lock, const char* data, std::size_t size) {
+
+            while (size > 0) {
+
+                if (m_head - m_tail + size > m_ring.size()) {
+                    switch (m_policy) {
+                        case BackpressurePolicy::Drop:
+                            ++m_droppedWrites;
+                            m_droppedBytes += size;
+                            return;
+
+                        case BackpressurePolicy::Grow:
+                            Grow(lock, m_head - m_tail + size);
+                            break;
+
+                        case BackpressurePolicy::Block: {
+                            // Blocks larger than the whole buffer are passed on in pieces.
+                            auto needed = std::min(size, m_ring.size());
+                            m_spaceAvailable.wait(lock, [&] { return m_ring.size() - (m_head - m_tail) >= needed || m_error; });
+                            ThrowPendingError();
+                            break;
+                        }
+                    }
+                }
+
+                auto count = std::min(size, m_ring.size() - static_cast<std::size_t>(m_head - m_tail));
+                CopyIn(data, count);
+                data += count;
+                size -= count;
+                if (m_writerIdle) m_dataAvailable.notify_one();
+            }
+        }
+
+        /**
+         * @brief Copy text into the free part of the ring buffer. Called with the mutex held.
+         */
+        void CopyIn(const char* data, std::size_t size) {
+
+            auto position = static_cast<std::size_t>(m_head % m_ring.size());
+            auto first    = std::min(size, m_ring.size() - position);
+            std::copy(data, data + first, m_ring.data() + position);
+            std::copy(data + first, data + size, m_ring.data());
+            m_head += size;
+        }
+
+        /**
+         * @brief Enlarge the ring buffer to hold at least the given number of bytes.
+         * @details The writer thread may be reading from the buffer, so the contents are moved to a new buffer
+         * only once it is idle.
+         * @param lock The lock on the mutex, held by the caller.
+         * @param required The number of bytes the buffer must be able to hold.
+         */
+        void Grow(std::unique_lock<std::mutex>& lock, std::size_t required) {
+
+            m_spaceAvailable.wait(lock, [&] { return !m_writing; });
+
+            auto size = m_ring.size();
+            while (size < required) size *= 2;
+
+            std::vector<char> ring(size);
+            for (auto index = m_tail; index != m_head; ++index)
+                ring[static_cast<std::size_t>(index % size)] = m_ring[static_cast<std::size_t>(index % m_ring.size())];
+            m_ring.swap(ring);
+        }
+
+        /**
+         * @brief Rethrow an exception raised by the downstream sink. Called with the mutex held.
+         */
+        void ThrowPendingError() {
+
+            if (m_error) {
+                auto error = m_error;
+                m_error    = nullptr;
+                std::rethrow_exception(error);
+            }
+        }
+
+        /**
+         * @brief The loop of the writer thread.
+         */
+        void WriterLoop() {
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (true) {
+
+                m_writerIdle = true;
+                m_dataAvailable.wait(lock, [&] { return m_head != m_tail || m_flushCompleted < m_flushRequested || m_stop; });
+                m_writerIdle = false;
+
+                if (m_head != m_tail) {
+
+                    // Write the contiguous part of the buffered text. Producers only write to the free part of the
+                    // buffer, and Grow waits for this write to complete, so the mutex can be released meanwhile.
+                    auto        position = static_cast<std::size_t>(m_tail % m_ring.size());
+                    auto        count    = std::min(static_cast<std::size_t>(m_head - m_tail), m_ring.size() - position);
+                    const auto* data     = m_ring.data() + position;
+                    m_writing            = true;
+                    lock.unlock();
+                    try {
+                        if (!m_failed) m_downstream.Write(data, count);
+                    }
+                    catch (...) {
+                        lock.lock();
+                        m_error  = std::current_exception();
+                        m_failed = true;
+                        lock.unlock();
+                    }
+                    lock.lock();
+                    m_writing = false;
+                    m_tail += count;
+                    m_spaceAvailable.notify_all();
+                }
+
+                if (m_flushCompleted < m_flushRequested && m_tail >= m_flushTarget) {
+                    auto request = m_flushRequested;
+                    lock.unlock();
+                    try {
+                        if (!m_failed) m_downstream.Flush();
+                    }
+                    catch (...) {
+                        lock.lock();
+                        m_error  = std::current_exception();
+                        m_failed = true;
+                        lock.unlock();
+                    }
+                    lock.lock();
+                    m_flushCompleted = request;
+                    m_flushDone.notify_all();
+                }
+
+                if (m_stop && m_head == m_tail && m_flushCompleted == m_flushRequested) break;
+            }
+
+            lock.unlock();
+            try {
+                if (!m_failed) m_downstream.Flush();
+            }
+            catch (...) {
+            }
+        }
+
+        std::unique_ptr<Sink> m_ownedSink; /**< the downstream sink, when constructed with a stream */
+        Sink&                 m_downstream; /**< the sink written to by the background thread */
+        std::vector<char>     m_ring; /**< the ring buffer */
+        BackpressurePolicy    m_policy; /**< what to do when the ring buffer is full */
+
+        std::thread             m_writer; /**< the background thread */
+        mutable std::mutex      m_mutex; /**< protects all members below */
+        std::condition_variable m_dataAvailable; /**< wakes the background thread */
+        std::condition_variable m_spaceAvailable; /**< wakes writers waiting for room in the buffer */
+        std::condition_variable m_flushDone; /**< signals completed flushes */
+        std::uint64_t           m_head{0}; /**< the total number of bytes written into the buffer */
+        std::uint64_t           m_tail{0}; /**< the total number of bytes passed on to the downstream sink */
+        std::uint64_t           m_flushTarget{0}; /**< the value m_tail must reach before the pending flush */
+        std::uint64_t           m_flushRequested{0}; /**< the number of flushes requested */
+        std::uint64_t           m_flushCompleted{0}; /**< the number of flushes completed */
+        std::uint64_t           m_droppedWrites{0}; /**< the number of writes discarded */
+        std::uint64_t           m_droppedBytes{0}; /**< the number of bytes discarded */
+        std::exception_ptr      m_error; /**< an exception from the downstream sink, not yet reported */
+        bool                    m_failed{false}; /**< has the downstream sink failed? Then text is discarded */
+        bool                    m_writing{false}; /**< is the background thread reading from the buffer? */
+        bool                    m_splitting{false}; /**< is a block larger than the buffer being passed on? */
+        bool                    m_writerIdle{false}; /**< is the background thread waiting for text? */
+        bool                    m_stop{false}; /**< has the destructor been called? */
+    };
+
+#ifdef TABLEPRINTER_HAS_FD_SINK
+
+    /**
+     * @brief A sink writing straight to a POSIX file descriptor, bypassing iostreams.
+     *
+     * Usage:
+     *   int fd = ::open("report.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+     *   {
+     *       trl::FileDescriptorSink sink(fd);
+     *       trl::TablePrinter tp(sink);
+     *       ...
+     *   }
+     *   ::close(fd);
+     *
+     * Small blocks (rows, borders) are gathered in a staging buffer that is written when full. Large blocks
+     * (e.g. the batches written by PrintRows and PrintColumns) are not copied: they are written together with
+     * the staged text in a single writev call. Staged text has not reached the file yet, so the file offset
+     * (e.g. from lseek) lags behind what has been written to the sink until Flush() is called. The file
+     * descriptor is not closed by the sink. Write errors are reported as std::system_error.
+     */
+    class FileDescriptorSink : public Sink {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param fd The file descriptor to write to.
+         * @param batchSize The size of the staging buffer; also the smallest block that is written without copying.
+         */
+        explicit FileDescriptorSink(int fd, std::size_t batchSize = 256 * 1024)
+                : m_fd(fd),
+                  m_batchSize(std::max<std::size_t>(batchSize, 1)) {
+
+            m_staging.reserve(m_batchSize);
+        }
+
+        /**
+         * @brief
+         * @param other
+         */
+        FileDescriptorSink(const FileDescriptorSink& other) = delete;
+
+        /**
+         * @brief
+         * @param other
+         * @return
+         */
+        FileDescriptorSink& operator=(const FileDescriptorSink& other) = delete;
+
+        /**
+         * @brief Destructor. Writes the staged text; errors are ignored.
+         */
+        ~FileDescriptorSink() override {
+
+            try {
+                Flush();
+            }
+            catch (...) {
+            }
+        }
+
+        void Write(const char* data, std::size_t size) override {
+
+            if (size >= m_batchSize) {
+                WriteAll(data, size);
+                return;
+            }
+
+            if (m_staging.size() + size > m_batchSize) WriteAll(nullptr, 0);
+            m_staging.insert(m_staging.end(), data, data + size);
+        }
+
+        void Flush() override {
+
+            if (!m_staging.empty()) WriteAll(nullptr, 0);
+        }
+
+        /**
+         * @brief Get the number of write system calls made so far.
+         * @return The number of calls.
+         */
+        std::uint64_t GetWriteCalls() const {
+
+            return m_writeCalls;
+        }
+
+    private:
+
+        /**
+         * @brief Write the staged text followed by the given block, retrying until everything has been written.
+         */
+        void WriteAll(const char* data, std::size_t size) {
+
+            iovec vectors[2];
+            int   count = 0;
+            if (!m_staging.empty()) vectors[count++] = {m_staging.data(), m_staging.size()};
+            if (size > 0) vectors[count++] = {const_cast<char*>(data), size};
+
+            auto* current = vectors;
+            while (count > 0) {
+
+                ++m_writeCalls;
+                auto written = ::writev(m_fd, current, count);
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    m_staging.clear();
+                    throw std::system_error(errno, std::generic_category(), "writev failed");
+                }
+
+                // Skip what has been written, including a partially written vector.
+                auto remaining = static_cast<std::size_t>(written);
+                while (count > 0 && remaining >= current->iov_len) {
+                    remaining -= current->iov_len;
+                    ++current;
+                    --count;
+                }
+                if (count > 0) {
+                    current->iov_base = static_cast<char*>(current->iov_base) + remaining;
+                    current->iov_len -= remaining;
+                }
+            }
+
+            m_staging.clear();
+        }
+
+        int               m_fd; /**< the file descriptor written to */
+        std::size_t       m_batchSize; /**< the size of the staging buffer */
+        std::vector<char> m_staging; /**< text waiting to be written */
+        std::uint64_t     m_writeCalls{0}; /**< the number of write system calls made */
+    };
+
+#endif
+
+    /**
+     * @brief The aggregates that can be shown for a column in the footer of a table; see TablePrinter::AddAggregate.
+     */
+    enum class Aggregate : unsigned {
+        Count = 1, /**< the number of numbers in the column */
+        Sum   = 2, /**< their sum */
+        Min   = 4, /**< the smallest */
+        Max   = 8, /**< the largest */
+        Mean  = 16 /**< their mean */
+    };
+
+    /**
+     * @brief The order of the rows when sorted by a column; see TablePrinter::AddSortColumn.
+     */
+    enum class SortOrder {
+        Ascending, /**< smallest first */
+        Descending /**< largest first */
+    };
+
+    /**
+     * @brief A cell style: a combination of rang colors and text styles, compiled into one escape sequence.
+     *
+     * Usage:
+     *   tp.StyleAbove(2, 500.0, trl::CellStyle(rang::fg::red, rang::style::bold));
+     */
+    class CellStyle {
+    public:
+
+        /**
+         * @brief Constructor. The default style leaves the cells unchanged.
+         */
+        CellStyle() = default;
+
+        /**
+         * @brief Constructor.
+         * @param attributes The rang::style, rang::fg, rang::bg, rang::fgB and rang::bgB values to combine.
+         */
+        template<typename... Attributes>
+        explicit CellStyle(Attributes... attributes) {
+
+            static_assert((IsAttribute<Attributes> && ...),
+                          "A cell style is made of rang::style, rang::fg, rang::bg, rang::fgB and rang::bgB values");
+
+            m_sequence = "\033[";
+            ((m_sequence += std::to_string(static_cast<int>(attributes)), m_sequence += ';'), ...);
+            m_sequence.back() = 'm';
+        }
+
+        /**
+         * @brief Get the escape sequence of the style.
+         * @return The escape sequence; empty for the default style.
+         */
+        const std::string& GetSequence() const {
+
+            return m_sequence;
+        }
+
+    private:
+        template<typename T>
+        static constexpr bool IsAttribute = std::is_same<T, rang::style>::value || std::is_same<T, rang::fg>::value ||
+                                            std::is_same<T, rang::bg>::value || std::is_same<T, rang::fgB>::value ||
+                                            std::is_same<T, rang::bgB>::value;
+
+        std::string m_sequence; /**< the escape sequence */
+    };
+
+    /**
+     * @brief
+     */
+    class endl
+    {
+    };
+
+    /**
+     * @brief A complete row of cells, built independently of any printer and printed with TablePrinter::PrintRow.
+     * @details A Row owns copies of its cells, so it can be built on one thread and printed on another; see
+     * ConcurrentTablePrinter. Numbers are kept as numbers and formatted when the row is printed.
+     *
+     *   trl::Row row;
+     *   row << "Worker 3" << 1254 << 0.25;
+     *   tp.PrintRow(row);
+     */
+    class Row {
+    public:
+
+        /**
+         * @brief Constructor.
+         */
+        Row() = default;
+
+        /**
+         * @brief Constructor.
+         * @param resource The memory resource the cells are allocated from.
+         */
+        explicit Row(std::pmr::memory_resource* resource)
+                : m_cells(resource) {}
+
+        /**
+         * @brief Append a cell to the row.
+         * @tparam T The type of the value.
+         * @param value The value.
+         * @return A reference to the row.
+         */
+        template<typename T>
+        Row& operator<<(const T& value) {
+
+            m_cells.Push(value, detail::ThreadFormatter());
+            return *this;
+        }
+
+        /**
+         * @brief Get the number of cells in the row.
+         * @return The number of cells.
+         */
+        std::size_t GetCellCount() const {
+
+            return m_cells.CellCount();
+        }
+
+        /**
+         * @brief Remove all cells from the row. The memory is kept for reuse.
+         */
+        void Clear() {
+
+            m_cells.Clear();
+        }
+
+    private:
+        friend class TablePrinter;
+
+        detail::RowStore m_cells; /**< the cells of the row */
+    };
+
+    /**
+     * @brief A table whose rows are fetched on demand, so that a window of it can be printed without producing
+     * the rest; see TablePrinter::PrintWindow and Pager.
+     */
+    class DataSource {
+    public:
+
+        /**
+         * @brief Destructor.
+         */
+        virtual ~DataSource() = default;
+
+        /**
+         * @brief Get the number of rows.
+         * @return The number of rows.
+         */
+        virtual std::size_t GetRowCount() const = 0;
+
+        /**
+         * @brief Get the cells of a row.
+         * @param row The row index, less than GetRowCount().
+         * @param cells An empty row to append the cells to; one for each column.
+         */
+        virtual void GetRow(std::size_t row, Row& cells) const = 0;
+    };
+
+    /**
+     * @brief A DataSource calling functions for the row count and the rows.
+     *
+     *   trl::FunctionDataSource source(trades.size(), [&](std::size_t i, trl::Row& row) {
+     *       row << trades[i].symbol << trades[i].price;
+     *   });
+     */
+    class FunctionDataSource : public DataSource {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param rowCount A function returning the number of rows.
+         * @param getRow A function appending the cells of a row to a trl::Row.
+         */
+        FunctionDataSource(std::function<std::size_t()> rowCount, std::function<void(std::size_t, Row&)> getRow)
+                : m_rowCount(std::move(rowCount)),
+                  m_getRow(std::move(getRow)) {}
+
+        /**
+         * @brief Constructor.
+         * @param rowCount The number of rows.
+         * @param getRow A function appending the cells of a row to a trl::Row.
+         */
+        FunctionDataSource(std::size_t rowCount, std::function<void(std::size_t, Row&)> getRow)
+                : FunctionDataSource([rowCount] { return rowCount; }, std::move(getRow)) {}
+
+        std::size_t GetRowCount() const override {
+
+            return m_rowCount();
+        }
+
+        void GetRow(std::size_t row, Row& cells) const override {
+
+            m_getRow(row, cells);
+        }
+
+    private:
+        std::function<std::size_t()>           m_rowCount; /**< returns the number of rows */
+        std::function<void(std::size_t, Row&)> m_getRow; /**< appends the cells of a row */
+    };
+
+    /**
+     * @brief Print a pretty table into your output of choice.
+     *
+     * Usage:
+     *   TablePrinter tp(&std::cout);
+     *   tp.AddColumn("Name", 25);
+     *   tp.AddColumn("Age", 3);
+     *   tp.AddColumn("Position", 30);
+     *
+     *   tp.PrintHeader();
+     *   tp << "Dat Chu" << 25 << "Research Assistant";
+     *   tp << "John Doe" << 26 << "Professional Anonymity";
+     *   tp << "Jane Doe" << tp.SkipToNextLine();
+     *   tp << "Tom Doe" << 7 << "Student";
+     *   tp.PrintFooter();
+     *
+     * Each row is assembled in an internal buffer (borders, separators and padding included) and written
+     * to the output stream in a single call when the last column of the row has been completed. The
+     * same goes for titles, headers and footers. The buffer is reused between rows, so in steady state
+     * printing a row involves a single write to the stream buffer.
+     *
+     * With SetAutoWidth(), the column widths are fitted to the content: rows are buffered and measured
+     * before anything is printed, and the widths given to AddColumn act as upper limits.
+     *
+     * SetOutputFormat() prints the table as CSV, TSV, Markdown or JSON Lines instead of a boxed table, and
+     * AddOutput() prints it to further sinks, each in a format of its own, from a single formatting pass.
+     *
+     * @todo Add support for padding in each table cell
+     **/
+    class TablePrinter {
+    public:
+
+        /**
+         * @brief
+         * @param output
+         * @param separator
+         */
+        explicit TablePrinter(std::ostream& output = std::cout, const std::string& separator = "|")
+                : m_ownedSink(std::make_unique<StreamSink>(output)),
+                  m_sink(*m_ownedSink),
+                  m_columnSeparator(separator) {
+
+            UpdateLayout();
+            DetectColor();
+        }
+
+        /**
+         * @brief
+         * @param sink The sink to print to, e.g. an AsyncSink.
+         * @param separator
+         */
+        explicit TablePrinter(Sink& sink, const std::string& separator = "|")
+                : m_sink(sink),
+                  m_columnSeparator(separator) {
+
+            UpdateLayout();
+            DetectColor();
+        }
+
+        /**
+         * @brief
+         */
+        TablePrinter(const TablePrinter& other) = delete;
+
+        /**
+         * @brief
+         * @param other
+         */
+        TablePrinter(TablePrinter&& other) = delete;
+
+        /**
+         * @brief Destructor. Rows still buffered for measuring the column widths are printed.
+         */
+        ~TablePrinter() {
+
+            try {
+                if (m_widthsPending) ResolveWidths();
+            }
+            catch (...) {
+            }
+        }
+
+        /**
+         * @brief
+         * @param other
+         * @return
+         */
+        TablePrinter& operator=(const TablePrinter& other) = delete;
+
+        /**
+         * @brief
+         * @param other
+         * @return
+         */
+        TablePrinter& operator=(TablePrinter&& other) = delete;
+
+        /**
+         * @brief
+         * @return
+         */
+        int GetColumnCount() const {
+
+            return m_columnTitles.size();
+        }
+
+        /**
+         * @brief
+         * @return
+         */
+        int GetTableWidth() const {
+
+            return m_tableWidth;
+        }
+
+        /**
+         * @brief
+         * @param separator
+         */
+        void SetSeparator(const std::string& separator) {
+
+            if (m_columnIndex != 0) {
+                throw std::logic_error("Cannot change the separator while the current row is incomplete");
+            }
+
+            m_columnSeparator = separator;
+            UpdateLayout();
+        }
+
+        /**
+         * @brief
+         */
+        void SetFlushLeft() {
+
+            m_flushLeft = true;
+            UpdateLayout();
+        }
+
+        /**
+         * @brief
+         */
+        void SetFlushRight() {
+
+            m_flushLeft = false;
+            UpdateLayout();
+        }
+
+        /**
+         * @brief Wrap text that is too wide for its column over several lines, instead of letting it overflow.
+         * @details Cells are broken at spaces and newlines; a word wider than the column is broken where the line
+         * is full. A row with wrapped cells takes up as many lines as its longest cell. The setting applies to the
+         * existing columns and to those added later.
+         * @param wrap Wrap long cells?
+         */
+        void SetWordWrap(bool wrap = true) {
+
+            if (m_columnIndex != 0) {
+                throw std::logic_error("Cannot change word wrapping while the current row is incomplete");
+            }
+
+            m_wrapNewColumns = wrap;
+            m_wrapColumns.assign(m_columnTitles.size(), wrap);
+            UpdateLayout();
+        }
+
+        /**
+         * @brief Wrap text that is too wide for one column over several lines, instead of letting it overflow.
+         * @param column The column index.
+         * @param wrap Wrap long cells?
+         */
+        void SetWordWrap(int column, bool wrap) {
+
+            if (column < 0 || column >= GetColumnCount()) {
+                throw std::invalid_argument("Column index is out of range");
+            }
+
+            if (m_columnIndex != 0) {
+                throw std::logic_error("Cannot change word wrapping while the current row is incomplete");
+            }
+
+            m_wrapColumns[static_cast<std::size_t>(column)] = wrap;
+            UpdateLayout();
+        }
+
+        /**
+         * @brief Choose whether cell styles are printed.
+         * @details By default, this follows rang::setControlMode at the time the printer is constructed: with
+         * rang::control::Auto, styles are printed if the output stream is a terminal that supports colors. The
+         * stream is checked once, at construction; printers writing to a sink other than a StreamSink are taken
+         * not to support colors.
+         * @param mode Off, Auto or Force.
+         */
+        void SetStyling(rang::control mode) {
+
+            m_colorEnabled = mode == rang::control::Force || (mode == rang::control::Auto && m_colorSupported);
+            m_styled       = m_colorEnabled && !m_styles.Empty();
+        }
+
+        /**
+         * @brief Style the numbers in a column that are greater than a threshold.
+         * @details The rules of a column are tried in the order they were added; the first match decides the style.
+         * The escape sequences are added around the cells, and do not count towards the column widths.
+         * @param column The column index.
+         * @param threshold The threshold.
+         * @param style The style.
+         */
+        void StyleAbove(int column, double threshold, const CellStyle& style) {
+
+            AddStyleRule(column, {detail::StyleSheet::Rule::Kind::Above, threshold, {}, {}, style.GetSequence()});
+        }
+
+        /**
+         * @brief Style the numbers in a column that are less than a threshold.
+         * @param column The column index.
+         * @param threshold The threshold.
+         * @param style The style.
+         */
+        void StyleBelow(int column, double threshold, const CellStyle& style) {
+
+            AddStyleRule(column, {detail::StyleSheet::Rule::Kind::Below, threshold, {}, {}, style.GetSequence()});
+        }
+
+        /**
+         * @brief Style the numbers in a column for which a predicate holds.
+         * @details Predicates may be called from several threads at once; see SetFormattingThreads.
+         * @param column The column index.
+         * @param predicate The predicate, taking the value as a double.
+         * @param style The style.
+         */
+        void StyleIf(int column, std::function<bool(double)> predicate, const CellStyle& style) {
+
+            AddStyleRule(column, {detail::StyleSheet::Rule::Kind::Number, 0.0, std::move(predicate), {}, style.GetSequence()});
+        }
+
+        /**
+         * @brief Style the text cells (anything but numbers) in a column for which a predicate holds.
+         * @param column The column index.
+         * @param predicate The predicate, taking the text of the cell.
+         * @param style The style.
+         */
+        void StyleIf(int column, std::function<bool(std::string_view)> predicate, const CellStyle& style) {
+
+            AddStyleRule(column, {detail::StyleSheet::Rule::Kind::Text, 0.0, {}, std::move(predicate), style.GetSequence()});
+        }
+
+        /**
+         * @brief Shade every second row of each table.
+         * @param style The style of the shaded rows, e.g. a background color; the default style for no shading.
+         */
+        void SetRowShading(const CellStyle& style) {
+
+            m_styles.SetShading(style.GetSequence());
+            m_styled = m_colorEnabled && !m_styles.Empty();
+        }
+
+        /**
+         * @brief Remove all style rules and the row shading.
+         */
+        void ClearStyles() {
+
+            m_styles.Clear();
+            m_styled = false;
+        }
+
+        /**
+         * @brief Show an aggregate of the numbers in a column in the footer of each table.
+         * @details The aggregates are updated as the values are printed (or buffered), so no second pass over the
+         * data is needed. PrintFooter prints one summary row per aggregate, labelled in the first column without
+         * aggregates, and starts over for the next table. Cells that are not numbers are ignored.
+         * @param column The column index.
+         * @param aggregate The aggregate.
+         */
+        void AddAggregate(int column, Aggregate aggregate) {
+
+            CheckColumn(column);
+            m_aggregates[static_cast<std::size_t>(column)].Request(static_cast<unsigned>(aggregate));
+            m_aggregating = true;
+        }
+
+        /**
+         * @brief Show an approximate percentile of the numbers in a column in the footer of each table.
+         * @details The percentile is estimated in constant memory with the P-square algorithm; it is exact for
+         * tables of up to five numbers.
+         * @param column The column index.
+         * @param percentile The percentile, from 0 to 100, e.g. 99 for the 99th percentile.
+         */
+        void AddPercentile(int column, double percentile) {
+
+            CheckColumn(column);
+            if (!(percentile >= 0 && percentile <= 100)) {
+                throw std::invalid_argument("Percentile has to be between 0 and 100");
+            }
+
+            auto& aggregate = m_aggregates[static_cast<std::size_t>(column)];
+            if (!aggregate.HasQuantile(percentile / 100)) aggregate.AddQuantile(percentile / 100);
+            if (std::find(m_percentiles.begin(), m_percentiles.end(), percentile) == m_percentiles.end()) {
+                m_percentiles.insert(std::upper_bound(m_percentiles.begin(), m_percentiles.end(), percentile), percentile);
+            }
+            m_aggregating = true;
+        }
+
+        /**
+         * @brief Stop showing aggregates.
+         */
+        void ClearAggregates() {
+
+            m_aggregates.assign(m_columnTitles.size(), detail::ColumnAggregate());
+            m_percentiles.clear();
+            m_aggregating = false;
+        }
+
+        /**
+         * @brief Sort the rows of each table by a column; call again to break ties by further columns.
+         * @details Rows are buffered until the footer is printed (or Flush() is called), and then printed in
+         * sorted order. Titles and headers have to come before the buffered rows; printing one after them throws
+         * std::logic_error. Numbers sort before text, and blank cells and NaN always sort last. Rows that compare
+         * equal keep the order in which they were received. Large tables are sorted on the threads set with
+         * SetFormattingThreads.
+         * @param column The column index.
+         * @param order The sort order.
+         */
+        void AddSortColumn(int column, SortOrder order = SortOrder::Ascending) {
+
+            CheckColumn(column);
+            CheckSortChange();
+            m_sortColumns.push_back({static_cast<std::size_t>(column), order});
+            UpdateSorting();
+        }
+
+        /**
+         * @brief Print only the first rows of each table in sorted order, e.g. the ten largest of a column.
+         * @details The rows are streamed through a bounded heap, so no more than twice the given number of rows
+         * is held in memory, however many rows are printed. The aggregates still cover all rows. Without sort
+         * columns, the first rows received are kept.
+         * @param count The number of rows to print, or zero for all rows.
+         */
+        void SetTopRows(std::size_t count) {
+
+            CheckSortChange();
+            m_topRows = count;
+            UpdateSorting();
+        }
+
+        /**
+         * @brief Stop sorting the rows, and print all of them in the order they are received.
+         */
+        void ClearSortColumns() {
+
+            CheckSortChange();
+            m_sortColumns.clear();
+            m_topRows = 0;
+            UpdateSorting();
+        }
+
+        /**
+         * @brief Set the format of the output, e.g. CSV for a file; the default is a boxed table.
+         * @details Only boxed tables are styled and have wrapped cells. Numbers are fitted to their column width
+         * in the boxed and Markdown formats; the delimited formats (CSV, TSV and JSON Lines) get them in full, in
+         * their shortest round-trip form, whatever the width and number format of the column. In JSON Lines,
+         * number cells are written as JSON numbers, and text cells as JSON strings.
+         */
+        void SetOutputFormat(OutputFormat format) {
+
+            if (m_columnIndex != 0) {
+                throw std::logic_error("Cannot change the output format while the current row is incomplete");
+            }
+
+            m_format = format;
+            UpdateLayout();
+        }
+
+        /**
+         * @brief Get the format of the output.
+         */
+        OutputFormat GetOutputFormat() const {
+
+            return m_format;
+        }
+
+        /**
+         * @brief Print the table to another sink as well, in a format of its own (tee mode).
+         * @details Each cell is formatted once for the boxed and Markdown outputs and once for the delimited ones
+         * (see SetOutputFormat), and its text laid out for every output, so printing a boxed table to the console
+         * and CSV to a file costs little more than the console alone. Buffered rows are then
+         * formatted on the calling thread; see SetFormattingThreads.
+         * @param sink The sink, which must outlive the printer.
+         * @param format The output format.
+         */
+        void AddOutput(Sink& sink, OutputFormat format) {
+
+            if (m_columnIndex != 0) {
+                throw std::logic_error("Cannot add an output while the current row is incomplete");
+            }
+
+            m_outputs.push_back({nullptr, &sink, format});
+            UpdateLayout();
+        }
+
+        /**
+         * @brief Print the table to another stream as well, in a format of its own (tee mode); see AddOutput(Sink&, OutputFormat).
+         * @param output The stream, which must outlive the printer.
+         * @param format The output format.
+         */
+        void AddOutput(std::ostream& output, OutputFormat format) {
+
+            auto sink = std::make_unique<StreamSink>(output);
+            AddOutput(*sink, format);
+            m_outputs.back().ownedSink = std::move(sink);
+        }
+
+        /**
+         * @brief Remove the outputs added with AddOutput.
+         */
+        void ClearOutputs() {
+
+            if (m_columnIndex != 0) {
+                throw std::logic_error("Cannot remove the outputs while the current row is incomplete");
+            }
+
+            WriteBuffer();
+            m_outputs.clear();
+            UpdateLayout();
+        }
+
+        /**
+         * @brief Let the column widths be determined by the content.
+         * @details Rows are buffered until sampleRows rows have been received (or, if sampleRows is zero, until
+         * the footer is printed or Flush() is called). The width of each column is then set to fit the widest
+         * title or cell among the buffered rows, but never wider than the width given to AddColumn, and the
+         * title, header and buffered rows are printed. Later rows are printed directly, using the fitted widths.
+         * Each table (ended by PrintFooter) is measured anew.
+         * @param sampleRows The number of rows to measure, or zero to measure the whole table.
+         */
+        void SetAutoWidth(std::size_t sampleRows = 0) {
+
+            m_autoWidth     = true;
+            m_sampleRows    = sampleRows;
+            m_widthsPending = true;
+            m_widthsFitted  = false;
+        }
+
+        /**
+         * @brief Use the column widths given to AddColumn (the default). Any rows buffered for measuring are printed.
+         */
+        void SetFixedWidth() {
+
+            if (m_widthsPending) ResolveWidths();
+            m_autoWidth    = false;
+            m_columnWidths = m_maxWidths;
+            UpdateLayout();
+        }
+
+        /**
+         * @brief Format large buffered tables on several threads.
+         * @details When buffered rows are printed (see SetAutoWidth) and there are at least minRows of them, the
+         * rows are split into chunks that are formatted concurrently into separate buffers. The chunks are
+         * written to the output stream in order, from the calling thread.
+         * @param threadCount The number of threads to use, including the calling thread. Zero means one thread
+         * per hardware thread; one (the default) formats everything on the calling thread.
+         * @param minRows The smallest number of buffered rows worth splitting.
+         */
+        void SetFormattingThreads(unsigned threadCount = 0, std::size_t minRows = 65536) {
+
+            if (threadCount == 0) threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+            m_formattingThreads = threadCount;
+            m_parallelMinRows   = std::max<std::size_t>(minRows, 1);
+        }
+
+        /**
+         * @brief Allocate the rows, titles and headers buffered by SetAutoWidth from a memory resource.
+         * @details The storage is kept for reuse by later tables until ReleaseMemory() is called. The resource
+         * must outlive the printer, or the next call to SetMemoryResource. Rows cannot be buffered while the
+         * resource is changed.
+         * @param resource The memory resource, e.g. a std::pmr::monotonic_buffer_resource shared by many short
+         * lived printers.
+         */
+        void SetMemoryResource(std::pmr::memory_resource* resource) {
+
+            if (IsBuffering()) {
+                throw std::logic_error("Cannot change the memory resource while rows are buffered");
+            }
+
+            m_rows.Rebind(resource);
+            detail::Rebind(m_deferred, resource);
+            detail::Rebind(m_deferredTitles, resource);
+        }
+
+        /**
+         * @brief Keep the buffered rows, titles and headers of each table in a monotonic arena owned by the
+         * printer, and release the whole arena in one go when they have been printed.
+         * @param blockSize The size of the first block the arena allocates; later blocks grow geometrically.
+         */
+        void UseArena(std::size_t blockSize = 64 * 1024) {
+
+            auto arena = std::make_unique<std::pmr::monotonic_buffer_resource>(blockSize);
+            SetMemoryResource(arena.get());
+            m_arena = std::move(arena);
+        }
+
+        /**
+         * @brief Give the memory used for buffering rows back to the memory resource.
+         * @details With an arena (see UseArena), this is done automatically each time the buffered rows have been
+         * printed.
+         */
+        void ReleaseMemory() {
+
+            if (IsBuffering()) {
+                throw std::logic_error("Cannot release memory while rows are buffered");
+            }
+
+            m_rows.Release();
+            std::pmr::vector<Deferred>(m_deferred.get_allocator()).swap(m_deferred);
+            std::pmr::string(m_deferredTitles.get_allocator()).swap(m_deferredTitles);
+            if (m_arena) m_arena->release();
+        }
+
+        /**
+         * @brief
+         * @param columnTitle
+         * @param columnWidth The width of the column; with SetAutoWidth, the maximum width of the column.
+         */
+        void AddColumn(const std::string& columnTitle, int columnWidth) {
+
+            AddFormattedColumn(columnTitle, columnWidth, detail::NumberFormat());
+        }
+
+        /**
+         * @brief Add a column with a number format, e.g. ",.2f" for money, or ".1i" for byte counts.
+         * @details The format is compiled once, here; see detail::NumberFormat for the syntax. It applies to the
+         * integer and floating point cells of the column, including its aggregates.
+         * @param columnTitle The title of the column.
+         * @param columnWidth The width of the column; with SetAutoWidth, the maximum width of the column.
+         * @param format The format specification.
+         */
+        void AddColumn(const std::string& columnTitle, int columnWidth, std::string_view format) {
+
+            AddFormattedColumn(columnTitle, columnWidth, detail::NumberFormat(format));
+        }
+
+        /**
+         * @brief Print any buffered rows, and flush the sink.
+         */
+        void Flush() {
+
+            BusyScope busy(*this);
+            if (m_widthsPending) ResolveWidths();
+            FlushSink(m_sink);
+            for (auto& output : m_outputs) FlushSink(*output.sink);
+        }
+
+        /**
+         * @brief
+         * @param title
+         */
+        void PrintTitle(const std::string& title) {
+
+            BusyScope busy(*this);
+            if (m_widthsPending) {
+                CheckSortedPosition();
+                m_deferred.push_back({Deferred::Kind::Title, m_deferredTitles.size(), title.size(), m_bufferedRows});
+                m_deferredTitles += title;
+                return;
+            }
+
+            PrintTitleBlock(title);
+        }
+
+        /**
+         * @brief
+         */
+        void PrintHeader() {
+
+            BusyScope busy(*this);
+            if (m_widthsPending) {
+                CheckSortedPosition();
+                m_deferred.push_back({Deferred::Kind::Header, 0, 0, m_bufferedRows});
+                return;
+            }
+
+            AppendPart(&detail::RowSkeleton::Header);
+            m_tableRow = 0;
+            WriteBuffer();
+        }
+
+        /**
+         * @brief
+         */
+        void PrintFooter() {
+
+            BusyScope busy(*this);
+            if (m_widthsPending) {
+                if (m_aggregating) MeasureAggregates();
+                ResolveWidths();
+            }
+
+            if (m_aggregating) AppendAggregates();
+            AppendPart(&detail::RowSkeleton::Line);
+            m_tableRow = 0;
+            WriteBuffer();
+
+            // Measure the next table anew.
+            if (m_autoWidth) {
+                m_columnWidths  = m_maxWidths;
+                m_widthsPending = true;
+                m_widthsFitted  = false;
+                UpdateLayout();
+            }
+        }
+
+        /**
+         *
+         */
+        TablePrinter& operator<<(endl) {
+
+            while (m_columnIndex != 0) {
+                *this << "";
+            }
+            return *this;
+        }
+
+        /**
+         * @brief
+         * @details The value is taken by reference and formatted in place; strings and string views are copied
+         * straight into the row, without an intermediate std::string.
+         * @tparam T
+         * @param input
+         * @return
+         */
+        template<typename T>
+        TablePrinter& operator<<(const T& input) {
+
+            BusyScope busy(*this);
+            if (m_widthsPending) {
+                StoreCell(input);
+                return *this;
+            }
+
+            detail::NumberBuffer number;
+            detail::NumberBuffer plain;
+            BeginCell();
+            Accumulate(m_columnIndex, input);
+            auto cell = FormatCell(number, plain, input, static_cast<std::size_t>(m_columnIndex));
+            auto text = MainText(cell);
+            CountCell(static_cast<std::size_t>(m_columnIndex), text, IsNumber<T>);
+            FillCell(cell, m_styled ? m_styles.Select(m_columnIndex, m_tableRow, input, text) : std::string_view());
+            EndCell();
+            return *this;
+        }
+
+        /**
+         * @brief Print a row built with trl::Row.
+         * @param row The row. It must hold one cell for each column.
+         */
+        void PrintRow(const Row& row) {
+
+            BusyScope busy(*this);
+            if (row.GetCellCount() != static_cast<std::size_t>(GetColumnCount())) {
+                throw std::invalid_argument("The number of cells in the row must match the number of columns");
+            }
+
+            if (m_columnIndex != 0) {
+                throw std::logic_error("Cannot print a row while the current row is incomplete");
+            }
+
+            detail::NumberBuffer number;
+            detail::NumberBuffer plain;
+            const auto*          cells = row.m_cells.Row(0, row.GetCellCount());
+            for (std::size_t column = 0; column < row.GetCellCount(); ++column) {
+
+                if (m_widthsPending) {
+                    StoreCopy(row.m_cells, cells[column]);
+                    continue;
+                }
+
+                BeginCell();
+                AccumulateStored(column, cells[column]);
+                auto cell = FormatStored(number, plain, row.m_cells, cells[column], column);
+                auto text = MainText(cell);
+                CountCell(column, text, cell.number);
+                FillCell(cell, m_styled ? m_styles.SelectStored(column, m_tableRow, cells[column], text) : std::string_view());
+                EndCell();
+            }
+        }
+
+        /**
+         * @brief Print the rows [first, last) of a data source.
+         * @details Only the rows in the window are fetched from the source. They are fetched one at a time into a
+         * reused trl::Row, and written to the output in large blocks.
+         * @param source The data source.
+         * @param first The index of the first row to print.
+         * @param last One past the index of the last row to print; limited to the number of rows in the source.
+         */
+        void PrintWindow(const DataSource& source, std::size_t first, std::size_t last) {
+
+            BusyScope busy(*this);
+            if (m_columnIndex != 0) {
+                throw std::logic_error("Cannot print rows while the current row is incomplete");
+            }
+
+            last = std::min(last, source.GetRowCount());
+            for (auto index = first; index < last; ++index) {
+
+                m_windowRow.Clear();
+                source.GetRow(index, m_windowRow);
+                if (m_widthsPending) {
+                    PrintRow(m_windowRow);
+                    continue;
+                }
+
+                if (m_windowRow.GetCellCount() != static_cast<std::size_t>(GetColumnCount())) {
+                    throw std::invalid_argument("The number of cells in the row must match the number of columns");
+                }
+
+                const auto* cells = m_windowRow.m_cells.Row(0, m_windowRow.GetCellCount());
+                for (std::size_t column = 0; column < m_windowRow.GetCellCount(); ++column) AccumulateStored(column, cells[column]);
+
+                if (m_outputs.empty()) {
+                    detail::AppendStoredRows(m_formatter,
+                                             m_rowBuffer,
+                                             m_block,
+                                             m_windowRow.m_cells,
+                                             0,
+                                             1,
+                                             nullptr,
+                                             m_skeleton,
+                                             m_numberFormats,
+                                             m_styled ? &m_styles : nullptr,
+                                             m_tableRow,
+                                             CellStatistics());
+                    if constexpr(detail::StatisticsEnabled) ++m_statistics.rows;
+                }
+                else {
+                    AppendStoredRow(m_windowRow.m_cells, 0, m_tableRow);
+                }
+                ++m_rowIndex;
+                ++m_tableRow;
+
+                if (m_rowBuffer.size() >= s_writeBatchSize) WriteBuffer();
+            }
+
+            WriteBuffer();
+        }
+
+        /**
+         * @brief Print one row for each element in a range.
+         * @details Without projections, each element must be tuple-like (std::tuple, std::pair, std::array,
+         * ...) with one value per column. With projections, there must be one projection per column; each is
+         * a pointer to member or a callable, applied to the element with std::invoke. For example:
+         *
+         *   tp.PrintRows(employees, &Employee::name, &Employee::age, [](const Employee& e) { return e.salary / 12; });
+         *
+         * The rows are assembled back to back in the row buffer and written to the output in large blocks.
+         * @tparam Range The type of the range.
+         * @tparam Projections The types of the projections.
+         * @param rows The range of rows.
+         * @param projections The projections; either none, or one for each column.
+         */
+        template<typename Range, typename... Projections>
+        void PrintRows(const Range& rows, const Projections&... projections) {
+
+            BusyScope busy(*this);
+            if (m_columnIndex != 0) {
+                throw std::logic_error("Cannot print rows while the current row is incomplete");
+            }
+
+            constexpr auto projectionCount = sizeof...(Projections);
+            if constexpr(projectionCount == 0) {
+                using Element = std::decay_t<decltype(*std::begin(rows))>;
+                if (std::tuple_size<Element>::value != static_cast<std::size_t>(GetColumnCount())) {
+                    throw std::invalid_argument("The number of elements in each row must match the number of columns");
+                }
+            }
+            else {
+                if (projectionCount != static_cast<std::size_t>(GetColumnCount())) {
+                    throw std::invalid_argument("The number of projections must match the number of columns");
+                }
+            }
+
+            for (const auto& row : rows) {
+
+                if (m_widthsPending) {
+                    if constexpr(projectionCount == 0)
+                        std::apply([this](const auto&... cells) { (StoreCell(cells), ...); }, row);
+                    else
+                        (StoreCell(std::invoke(projections, row)), ...);
+                    continue;
+                }
+
+                if constexpr(projectionCount == 0) {
+                    std::apply([this](const auto&... cells) { AppendRow(std::index_sequence_for<decltype(cells)...>(), cells...); },
+                               row);
+                }
+                else {
+                    AppendRow(std::index_sequence_for<Projections...>(), std::invoke(projections, row)...);
+                }
+
+                if (m_rowBuffer.size() >= s_writeBatchSize) WriteBuffer();
+            }
+
+            WriteBuffer();
+        }
+
+        /**
+         * @brief Print a table from column data: one contiguous container (std::vector, std::array, C array, ...)
+         * per column, all of the same length.
+         * @details The columns are rendered in blocks of rows: for each column, the values in the block are
+         * formatted in a tight loop into a per-column text buffer, after which the texts are written into the
+         * slots of blank rows. This keeps the formatting loop for each column type free of per-cell dispatch.
+         *
+         *   std::vector<std::string> names = ...;
+         *   std::vector<double>      latencies = ...;
+         *   tp.PrintColumns(names, latencies);
+         *
+         * @tparam Columns The types of the column containers.
+         * @param columns The column containers; one for each column in the table.
+         */
+        template<typename... Columns>
+        void PrintColumns(const Columns&... columns) {
+
+            BusyScope busy(*this);
+            if (m_columnIndex != 0) {
+                throw std::logic_error("Cannot print columns while the current row is incomplete");
+            }
+
+            if (sizeof...(Columns) != static_cast<std::size_t>(GetColumnCount())) {
+                throw std::invalid_argument("The number of column arrays must match the number of columns");
+            }
+
+            const std::size_t rowCount = std::size(std::get<0>(std::forward_as_tuple(columns...)));
+            if (((std::size(columns) != rowCount) || ...)) {
+                throw std::invalid_argument("All column arrays must have the same length");
+            }
+
+            // Rows needed for measuring the column widths are taken one at a time.
+            std::size_t start = 0;
+            for (; start < rowCount && m_widthsPending; ++start) {
+                (StoreCell(std::data(columns)[start]), ...);
+            }
+
+            m_columnText.resize(sizeof...(Columns));
+            m_columnEnds.resize(sizeof...(Columns));
+            m_columnStyles.resize(sizeof...(Columns));
+            m_columnOtherText.resize(sizeof...(Columns));
+            m_columnOtherEnds.resize(sizeof...(Columns));
+            m_columnNumbers.resize(sizeof...(Columns));
+
+            for (std::size_t first = start; first < rowCount; first += s_columnBlockSize) {
+
+                auto last = std::min(first + s_columnBlockSize, rowCount);
+                FormatColumns(std::index_sequence_for<Columns...>(), first, last, columns...);
+
+                for (std::size_t row = 0; row < last - first; ++row) {
+
+                    OpenRow();
+                    for (std::size_t column = 0; column < sizeof...(Columns); ++column) {
+
+                        const auto& ends  = m_columnEnds[column];
+                        auto        begin = row == 0 ? 0 : ends[row - 1];
+                        auto        text  = std::string_view(m_columnText[column]).substr(begin, ends[row] - begin);
+                        CellText    cell{text, text, m_columnNumbers[column] != 0};
+
+                        const auto& otherEnds = m_columnOtherEnds[column];
+                        if (!otherEnds.empty()) {
+                            auto otherBegin = row == 0 ? 0 : otherEnds[row - 1];
+                            auto other      = std::string_view(m_columnOtherText[column]).substr(otherBegin, otherEnds[row] - otherBegin);
+                            (m_delimited ? cell.fitted : cell.plain) = other;
+                        }
+                        FillCell(cell, m_styled ? m_columnStyles[column][row] : std::string_view(), column);
+                    }
+                    ++m_rowIndex;
+                    ++m_tableRow;
+
+                    if (m_rowBuffer.size() >= s_writeBatchSize) WriteBuffer();
+                }
+            }
+
+            WriteBuffer();
+        }
+
+        /**
+         * @brief Get the statistics collected since construction or the last ResetStatistics.
+         * @details Statistics are only collected when TABLEPRINTER_ENABLE_STATISTICS is defined; otherwise all
+         * counts are zero. Rows still buffered for measuring the column widths are not counted until printed.
+         * @return The statistics.
+         */
+        TableStatistics GetStatistics() const {
+
+            auto statistics = m_statistics;
+            if (m_busyTime > statistics.writingTime)
+                statistics.formattingTime = std::chrono::duration_cast<std::chrono::nanoseconds>(m_busyTime - statistics.writingTime);
+            return statistics;
+        }
+
+        /**
+         * @brief Reset the statistics to zero.
+         */
+        void ResetStatistics() {
+
+            m_statistics = TableStatistics();
+            m_statistics.columns.resize(m_columnWidths.size());
+            m_busyTime = std::chrono::steady_clock::duration();
+        }
+
+        /**
+         * @brief Print the statistics as two tables: the totals, and the cells of each column.
+         * @param output The stream to print to.
+         */
+        void PrintStatistics(std::ostream& output) const {
+
+            auto statistics = GetStatistics();
+            auto toMilliseconds = [](std::chrono::nanoseconds time) { return std::chrono::duration<double, std::milli>(time).count(); };
+
+            TablePrinter totals(output);
+            totals.AddColumn("Rows", 14, ",");
+            totals.AddColumn("Bytes", 17, ",");
+            totals.AddColumn("Writes", 12, ",");
+            totals.AddColumn("Flushes", 10, ",");
+            totals.AddColumn("Formatting ms", 13, ",.1f");
+            totals.AddColumn("Writing ms", 13, ",.1f");
+            totals.PrintHeader();
+            totals << statistics.rows << statistics.bytes << statistics.writes << statistics.flushes
+                   << toMilliseconds(statistics.formattingTime) << toMilliseconds(statistics.writingTime);
+            totals.PrintFooter();
+
+            std::size_t titleWidth = 6;
+            for (const auto& title : m_columnTitles) titleWidth = std::max(titleWidth, detail::DisplayWidth(title));
+
+            TablePrinter columns(output);
+            columns.AddColumn("Column", static_cast<int>(titleWidth));
+            columns.AddColumn("Cells", 14, ",");
+            columns.AddColumn("Truncated", 14, ",");
+            columns.AddColumn("Overflowed", 14, ",");
+            columns.PrintHeader();
+            for (std::size_t column = 0; column < statistics.columns.size(); ++column) {
+                const auto& counts = statistics.columns[column];
+                columns << m_columnTitles[column] << counts.cells << counts.truncated << counts.overflowed;
+            }
+            columns.PrintFooter();
+        }
+
+    private:
+        friend class LiveTable;
+
+        /**
+         * @brief The text of a cell, in the forms the outputs need: fitted to the column for the boxed and Markdown
+         * formats, and in full for the delimited formats. Text cells have the same text in both.
+         */
+        struct CellText {
+            std::string_view fitted; /**< the text fitted to the column width; set if any output needs it */
+            std::string_view plain; /**< the text in full; set if any delimited output needs it */
+            bool             number{false}; /**< is the cell a number? */
+        };
+
+        /**
+         * @brief Add a column with a compiled number format.
+         */
+        void AddFormattedColumn(const std::string& columnTitle, int columnWidth, const detail::NumberFormat& format) {
+
+            if (columnWidth < 4) {
+                throw std::invalid_argument("Column width has to be >= 4");
+            }
+
+            if (m_columnIndex != 0) {
+                throw std::logic_error("Cannot add a column while the current row is incomplete");
+            }
+
+            m_columnTitles.emplace_back(columnTitle);
+            m_columnWidths.emplace_back(columnWidth);
+            m_maxWidths.emplace_back(columnWidth);
+            m_measuredWidths.emplace_back(0);
+            m_wrapColumns.emplace_back(m_wrapNewColumns);
+            m_aggregates.emplace_back();
+            m_numberFormats.push_back(format);
+            m_alignment.push_back(format.Alignment());
+            m_statistics.columns.emplace_back();
+            UpdateLayout();
+        }
+
+        /**
+         * @brief Are any rows, titles or headers buffered for measuring the column widths?
+         */
+        bool IsBuffering() const {
+
+            return m_rows.CellCount() > 0 || !m_deferred.empty();
+        }
+
+        /**
+         * @brief Print a title block.
+         */
+        void PrintTitleBlock(std::string_view title) {
+
+            auto totalWidth = 0;
+            for (auto& it : m_columnWidths) totalWidth += it;
+            totalWidth += m_columnWidths.size() - 1;
+
+            m_skeleton.AppendTitleBlock(m_rowBuffer, title, m_tableWidth, totalWidth);
+            for (auto& output : m_outputs) output.skeleton.AppendTitleBlock(output.buffer, title, m_tableWidth, totalWidth);
+            WriteBuffer();
+        }
+
+        /**
+         * @brief Format the values [first, last) of each column into the per-column text buffers.
+         */
+        template<std::size_t... Indices, typename... Columns>
+        void FormatColumns(std::index_sequence<Indices...>, std::size_t first, std::size_t last, const Columns&... columns) {
+
+            (FormatColumn(Indices, std::data(columns) + first, std::data(columns) + last), ...);
+        }
+
+        /**
+         * @brief Format a block of values from one column into its text buffer, recording where each cell ends.
+         * @details Numbers are also formatted into the other text buffer of the column if the outputs need both
+         * forms of them; see CellText.
+         */
+        template<typename T>
+        void FormatColumn(std::size_t column, const T* first, const T* last) {
+
+            auto& text      = m_columnText[column];
+            auto& ends      = m_columnEnds[column];
+            auto& styles    = m_columnStyles[column];
+            auto& other     = m_columnOtherText[column];
+            auto& otherEnds = m_columnOtherEnds[column];
+            auto  both      = IsNumber<T> && m_fittedCells && m_plainCells;
+
+            detail::NumberBuffer number;
+            detail::NumberBuffer plain;
+            text.clear();
+            ends.clear();
+            styles.clear();
+            other.clear();
+            otherEnds.clear();
+            m_columnNumbers[column] = IsNumber<T>;
+            for (auto row = m_tableRow; first != last; ++first, ++row) {
+                Accumulate(column, *first);
+                auto cell = FormatCell(number, plain, *first, column);
+                auto main = MainText(cell);
+                CountCell(column, main, IsNumber<T>);
+                if (m_styled) styles.push_back(m_styles.Select(column, row, *first, main));
+                text.append(main.data(), main.size());
+                ends.push_back(static_cast<std::uint32_t>(text.size()));
+                if (both) {
+                    auto alternative = m_delimited ? cell.fitted : cell.plain;
+                    other.append(alternative.data(), alternative.size());
+                    otherEnds.push_back(static_cast<std::uint32_t>(other.size()));
+                }
+            }
+        }
+
+        /**
+         * @brief Append a complete row to the row buffer, without writing it.
+         * @details The number of values must match the number of columns; this is checked by the callers.
+         */
+        template<std::size_t... Indices, typename... Ts>
+        void AppendRow(std::index_sequence<Indices...>, const Ts&... values) {
+
+            detail::NumberBuffer number;
+            OpenRow();
+            (AppendRowCell(number, Indices, values), ...);
+            ++m_rowIndex;
+            ++m_tableRow;
+        }
+
+        /**
+         * @brief Format a cell of a row appended by AppendRow, and write it into its slot.
+         */
+        template<typename T>
+        void AppendRowCell(detail::NumberBuffer& number, std::size_t column, const T& value) {
+
+            detail::NumberBuffer plain;
+            Accumulate(column, value);
+            auto cell = FormatCell(number, plain, value, column);
+            auto text = MainText(cell);
+            CountCell(column, text, IsNumber<T>);
+            FillCell(cell, m_styled ? m_styles.Select(column, m_tableRow, value, text) : std::string_view(), column);
+        }
+
+        /**
+         * @brief Store a cell for printing once the column widths have been determined.
+         */
+        template<typename T>
+        void StoreCell(const T& value) {
+
+            if (m_columnWidths.empty()) {
+                throw std::logic_error("Cannot print a cell in a table without columns");
+            }
+
+            AdvanceStored(m_rows.Push(value, m_formatter));
+        }
+
+        /**
+         * @brief Store a copy of a cell from another store, for printing once the column widths have been determined.
+         */
+        void StoreCopy(const detail::RowStore& source, const detail::StoredCell& cell) {
+
+            AdvanceStored(m_rows.PushCopy(source, cell));
+        }
+
+        /**
+         * @brief Measure a cell that has just been stored, and move on to the next column.
+         */
+        void AdvanceStored(const detail::StoredCell& cell) {
+
+            AccumulateStored(static_cast<std::size_t>(m_columnIndex), cell);
+            if (m_topRows == 0) {
+                auto& measured = m_measuredWidths[m_columnIndex];
+                measured       = std::max(measured, detail::NaturalWidth(m_rows, cell, m_numberFormats[m_columnIndex]));
+            }
+
+            if (m_columnIndex == GetColumnCount() - 1) {
+                m_columnIndex = 0;
+                ++m_rowIndex;
+                ++m_bufferedRows;
+                if (m_topRows != 0)
+                    KeepTopRows();
+                else if (m_sampleRows != 0 && !IsSorting() && m_bufferedRows >= m_sampleRows)
+                    ResolveWidths();
+            }
+            else {
+                ++m_columnIndex;
+            }
+        }
+
+        /**
+         * @brief Fit the column widths to the measured content, and print everything buffered so far.
+         * @details The widths are fitted once per table, and only with SetAutoWidth. Sorted rows are printed in
+         * order. An incomplete row is left in the row buffer, so it can be completed by subsequent cells, or, if
+         * the rows are sorted, it is kept buffered.
+         */
+        void ResolveWidths() {
+
+            auto columnCount = m_columnWidths.size();
+            if (m_autoWidth && !m_widthsFitted) {
+                // Only the kept rows of a top-K table are measured, as most rows are discarded.
+                for (auto row : m_topHeap) {
+                    const auto* cells = m_rows.Row(row, columnCount);
+                    for (std::size_t column = 0; column < columnCount; ++column) {
+                        auto& measured = m_measuredWidths[column];
+                        measured       = std::max(measured, detail::NaturalWidth(m_rows, cells[column], m_numberFormats[column]));
+                    }
+                }
+
+                for (std::size_t i = 0; i < m_columnWidths.size(); ++i) {
+                    auto width        = std::max({static_cast<int>(detail::DisplayWidth(m_columnTitles[i])), m_measuredWidths[i], 1});
+                    m_columnWidths[i] = std::min(width, m_maxWidths[i]);
+                }
+                m_widthsFitted = true;
+                UpdateLayout();
+            }
+            std::fill(m_measuredWidths.begin(), m_measuredWidths.end(), 0);
+            m_widthsPending = false;
+
+            auto rowCount = m_bufferedRows;
+            if (IsSorting()) {
+                SortRows();
+                rowCount = m_rowOrder.size();
+            }
+
+            std::size_t row = 0;
+            for (const auto& item : m_deferred) {
+                auto next = std::min(item.row, rowCount);
+                PrintStoredRows(row, next);
+                row = next;
+                if (item.kind == Deferred::Kind::Title)
+                    PrintTitleBlock(std::string_view(m_deferredTitles).substr(item.titleOffset, item.titleLength));
+                else
+                    PrintHeader();
+            }
+            PrintStoredRows(row, rowCount);
+            WriteBuffer();
+            m_rowOrder.clear();
+            m_topHeap.clear();
+
+            if (IsSorting()) {
+                m_rows.KeepRows({}, m_bufferedRows, columnCount);
+            }
+            else {
+                // Cells of an incomplete row are put in the row buffer, to be completed by the cells that follow.
+                detail::NumberBuffer number;
+                detail::NumberBuffer plain;
+                const auto*          partial = m_rows.Row(m_bufferedRows, columnCount);
+                for (int column = 0; column < m_columnIndex; ++column) {
+                    if (column == 0) OpenRow();
+                    auto cell = FormatStored(number, plain, m_rows, partial[column], static_cast<std::size_t>(column));
+                    auto text = MainText(cell);
+                    CountCell(static_cast<std::size_t>(column), text, cell.number);
+                    FillCell(cell, m_styled ? m_styles.SelectStored(column, m_tableRow, partial[column], text) : std::string_view(), static_cast<std::size_t>(column));
+                }
+                m_rows.Clear();
+            }
+
+            m_deferred.clear();
+            m_deferredTitles.clear();
+            m_bufferedRows  = 0;
+            m_widthsPending = IsSorting();
+            if (m_arena && !IsBuffering()) ReleaseMemory();
+        }
+
+        /**
+         * @brief Throw if rows are buffered, as the sort order of the rows cannot change while they are.
+         */
+        void CheckSortChange() const {
+
+            if (m_bufferedRows != 0 || m_columnIndex != 0) {
+                throw std::logic_error("Cannot change the sort order while rows are buffered");
+            }
+        }
+
+        /**
+         * @brief Throw if a title or header would follow rows that are buffered for sorting, as the rows are then
+         * printed in another order and it would have no place among them.
+         */
+        void CheckSortedPosition() const {
+
+            if (IsSorting() && (m_bufferedRows != 0 || m_columnIndex != 0)) {
+                throw std::logic_error("Cannot print a title or header after the rows of a sorted table");
+            }
+        }
+
+        /**
+         * @brief Are the rows sorted, or limited to the top rows?
+         */
+        bool IsSorting() const {
+
+            return !m_sortColumns.empty() || m_topRows != 0;
+        }
+
+        /**
+         * @brief Start buffering rows for sorting, or print the buffered rows when they are no longer sorted.
+         */
+        void UpdateSorting() {
+
+            if (IsSorting())
+                m_widthsPending = true;
+            else if (m_widthsPending && !(m_autoWidth && !m_widthsFitted))
+                ResolveWidths();
+        }
+
+        /**
+         * @brief Does a stored row sort before another?
+         * @details Rows that are equal in all sort columns keep the order in which they were received.
+         */
+        bool SortsBefore(std::size_t a, std::size_t b) const {
+
+            auto        columnCount = m_columnWidths.size();
+            const auto* first       = m_rows.Row(a, columnCount);
+            const auto* second      = m_rows.Row(b, columnCount);
+            for (const auto& key : m_sortColumns) {
+                const auto& x     = first[key.column];
+                const auto& y     = second[key.column];
+                auto        group = detail::SortGroup(x);
+                if (group != detail::SortGroup(y)) return group < detail::SortGroup(y);
+                auto order = detail::CompareStoredCells(m_rows, x, y);
+                if (order != 0) return key.order == SortOrder::Ascending ? order < 0 : order > 0;
+            }
+            return a < b;
+        }
+
+        /**
+         * @brief Keep the last buffered row if it is among the top rows, discarding the row it displaces.
+         * @details The kept rows are held in a heap with the last of them on top, so each row is compared with that
+         * one first. Displaced rows are removed from the store once they are as many as the kept ones, so the
+         * store never holds more than twice the number of top rows.
+         */
+        void KeepTopRows() {
+
+            auto before = [this](std::size_t a, std::size_t b) { return SortsBefore(a, b); };
+            auto row    = m_bufferedRows - 1;
+            if (m_topHeap.size() < m_topRows) {
+                m_topHeap.push_back(row);
+                std::push_heap(m_topHeap.begin(), m_topHeap.end(), before);
+                return;
+            }
+
+            if (!before(row, m_topHeap.front())) {
+                m_rows.DropLastRow(m_columnWidths.size());
+                --m_bufferedRows;
+                return;
+            }
+
+            std::pop_heap(m_topHeap.begin(), m_topHeap.end(), before);
+            m_topHeap.back() = row;
+            std::push_heap(m_topHeap.begin(), m_topHeap.end(), before);
+
+            if (m_bufferedRows >= 2 * m_topRows) {
+                // Renumbering the rows in ascending order keeps their relative order, so the heap can be rebuilt.
+                std::sort(m_topHeap.begin(), m_topHeap.end());
+                m_rows.KeepRows(m_topHeap, m_bufferedRows, m_columnWidths.size());
+                for (std::size_t index = 0; index < m_topHeap.size(); ++index) m_topHeap[index] = index;
+                std::make_heap(m_topHeap.begin(), m_topHeap.end(), before);
+                m_bufferedRows = m_topHeap.size();
+            }
+        }
+
+        /**
+         * @brief Put the buffered rows, or the kept top rows, in sorted order in m_rowOrder.
+         * @details Large tables are sorted in chunks on the formatting threads (see SetFormattingThreads), and
+         * the chunks are then merged.
+         */
+        void SortRows() {
+
+            if (m_topRows != 0) {
+                m_rowOrder.assign(m_topHeap.begin(), m_topHeap.end());
+            }
+            else {
+                m_rowOrder.resize(m_bufferedRows);
+                for (std::size_t row = 0; row < m_bufferedRows; ++row) m_rowOrder[row] = row;
+            }
+
+            auto before      = [this](std::size_t a, std::size_t b) { return SortsBefore(a, b); };
+            auto first       = m_rowOrder.begin();
+            auto rowCount    = m_rowOrder.size();
+            auto threadCount = static_cast<std::size_t>(m_formattingThreads);
+            if (threadCount <= 1 || rowCount < m_parallelMinRows) {
+                std::sort(first, m_rowOrder.end(), before);
+                return;
+            }
+
+            auto chunkRows = (rowCount + threadCount - 1) / threadCount;
+            auto sortChunk = [&](std::size_t chunk) {
+                auto begin = std::min(chunk * chunkRows, rowCount);
+                auto end   = std::min(begin + chunkRows, rowCount);
+                std::sort(first + begin, first + end, before);
+            };
+
+            std::vector<std::thread> workers;
+            for (std::size_t chunk = 1; chunk < threadCount; ++chunk) workers.emplace_back(sortChunk, chunk);
+            sortChunk(0);
+            for (auto& worker : workers) worker.join();
+
+            for (auto width = chunkRows; width < rowCount; width *= 2) {
+                for (std::size_t begin = 0; begin + width < rowCount; begin += 2 * width)
+                    std::inplace_merge(first + begin, first + begin + width, first + std::min(begin + 2 * width, rowCount), before);
+            }
+        }
+
+        /**
+         * @brief Print the stored rows [first, last), in the order of m_rowOrder if the rows are sorted.
+         * @details Large ranges are split into chunks that are formatted concurrently into separate buffers, and
+         * written to the output in order; see SetFormattingThreads.
+         */
+        void PrintStoredRows(std::size_t first, std::size_t last) {
+
+            const auto& layout    = m_skeleton;
+            const auto* styles    = m_styled ? &m_styles : nullptr;
+            const auto* order     = m_rowOrder.empty() ? nullptr : m_rowOrder.data();
+            auto        tableRow  = m_tableRow;
+            m_tableRow           += last - first;
+
+            if (!m_outputs.empty()) {
+                for (auto row = first; row < last; ++row) {
+                    AppendStoredRow(m_rows, order ? order[row] : row, tableRow + row - first);
+                    if (m_rowBuffer.size() >= s_writeBatchSize) WriteBuffer();
+                }
+                return;
+            }
+
+            if (m_formattingThreads <= 1 || last - first < m_parallelMinRows) {
+                if constexpr(detail::StatisticsEnabled) m_statistics.rows += last - first;
+                for (auto row = first; row < last; ++row) {
+                    detail::AppendStoredRows(m_formatter,
+                                             m_rowBuffer,
+                                             m_block,
+                                             m_rows,
+                                             row,
+                                             row + 1,
+                                             order,
+                                             layout,
+                                             m_numberFormats,
+                                             styles,
+                                             tableRow + row - first,
+                                             CellStatistics());
+                    if (m_rowBuffer.size() >= s_writeBatchSize) WriteBuffer();
+                }
+                return;
+            }
+
+            auto threadCount = m_formattingThreads;
+            while (m_workerFormatters.size() < threadCount) m_workerFormatters.push_back(std::make_unique<detail::CellFormatter>());
+            m_chunkBuffers.resize(threadCount);
+            if constexpr(detail::StatisticsEnabled) {
+                m_statistics.rows += last - first;
+                m_chunkStatistics.assign(threadCount, std::vector<TableStatistics::Column>(m_columnWidths.size()));
+            }
+            WriteBuffer();
+
+            // Format one wave of chunks (one per thread) at a time, writing each wave in order before the next.
+            std::vector<std::thread>        workers;
+            std::vector<std::exception_ptr> errors(threadCount);
+            for (auto wave = first; wave < last; wave += s_parallelChunkRows * threadCount) {
+
+                auto formatChunk = [&, wave](unsigned chunk) {
+                    try {
+                        auto&            buffer = m_chunkBuffers[chunk];
+                        auto             begin  = std::min(wave + chunk * s_parallelChunkRows, last);
+                        auto             end    = std::min(begin + s_parallelChunkRows, last);
+                        detail::RowBlock block;
+                        buffer.clear();
+                        detail::AppendStoredRows(*m_workerFormatters[chunk],
+                                                 buffer,
+                                                 block,
+                                                 m_rows,
+                                                 begin,
+                                                 end,
+                                                 order,
+                                                 layout,
+                                                 m_numberFormats,
+                                                 styles,
+                                                 tableRow + begin - first,
+                                                 detail::StatisticsEnabled ? &m_chunkStatistics[chunk] : nullptr);
+                    }
+                    catch (...) {
+                        errors[chunk] = std::current_exception();
+                    }
+                };
+
+                for (unsigned chunk = 1; chunk < threadCount; ++chunk) workers.emplace_back(formatChunk, chunk);
+                formatChunk(0);
+                for (auto& worker : workers) worker.join();
+                workers.clear();
+
+                for (auto& error : errors)
+                    if (error) std::rethrow_exception(error);
+
+                for (const auto& buffer : m_chunkBuffers)
+                    WriteToSink(m_sink, buffer.data(), buffer.size());
+            }
+
+            if constexpr(detail::StatisticsEnabled) {
+                for (const auto& chunk : m_chunkStatistics) {
+                    for (std::size_t column = 0; column < chunk.size(); ++column) {
+                        m_statistics.columns[column].cells += chunk[column].cells;
+                        m_statistics.columns[column].truncated += chunk[column].truncated;
+                        m_statistics.columns[column].overflowed += chunk[column].overflowed;
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Format a stored row once, and append it to the row buffer of each output.
+         */
+        void AppendStoredRow(const detail::RowStore& store, std::size_t row, std::size_t tableRow) {
+
+            detail::NumberBuffer number;
+            detail::NumberBuffer plain;
+            auto                 columnCount = m_columnWidths.size();
+            const auto*          cells       = store.Row(row, columnCount);
+            OpenRow();
+            for (std::size_t column = 0; column < columnCount; ++column) {
+                auto cell = FormatStored(number, plain, store, cells[column], column);
+                auto text = MainText(cell);
+                CountCell(column, text, cell.number);
+                FillCell(cell, m_styled ? m_styles.SelectStored(column, tableRow, cells[column], text) : std::string_view(), column);
+            }
+        }
+
+        /**
+         * @brief Recompute the table width, and compile the row skeletons, from the columns and the separator.
+         * @details Also works out which forms of the cells (see CellText) the outputs need.
+         */
+        void UpdateLayout() {
+
+            auto separatorWidth = static_cast<int>(detail::DisplayWidth(m_columnSeparator));
+            m_tableWidth        = 0;
+            for (auto width : m_columnWidths) m_tableWidth += width + separatorWidth;
+            m_skeleton.Build(m_columnTitles, m_columnWidths, m_columnSeparator, m_flushLeft, m_wrapColumns, m_format, m_alignment);
+            m_delimited   = detail::IsDelimited(m_format);
+            m_plainCells  = m_delimited;
+            m_fittedCells = !m_delimited;
+            for (auto& output : m_outputs) {
+                output.skeleton.Build(m_columnTitles, m_columnWidths, m_columnSeparator, m_flushLeft, m_wrapColumns, output.format, m_alignment);
+                (output.skeleton.Delimited() ? m_plainCells : m_fittedCells) = true;
+            }
+        }
+
+        /**
+         * @brief Prepare the row buffer for the next cell, opening a blank row if necessary.
+         */
+        void BeginCell() {
+
+            if (m_columnWidths.empty()) {
+                throw std::logic_error("Cannot print a cell in a table without columns");
+            }
+
+            if (m_columnIndex == 0) OpenRow();
+        }
+
+        /**
+         * @brief Append a blank row to the row buffer of each output.
+         */
+        void OpenRow() {
+
+            if constexpr(detail::StatisticsEnabled) ++m_statistics.rows;
+            m_skeleton.Open(m_rowBuffer, m_block);
+            for (auto& output : m_outputs) output.skeleton.Open(output.buffer, output.block);
+        }
+
+        /**
+         * @brief Write the text of a cell into its slot in the open row of each output.
+         * @details The text is formatted once in each form, and laid out for every output in the form it needs.
+         * Only the main output is styled.
+         */
+        void FillCell(const CellText& cell, std::string_view style, std::size_t column) {
+
+            m_skeleton.Fill(m_rowBuffer, m_block, column, MainText(cell), style, cell.number);
+            for (auto& output : m_outputs) {
+                auto text = output.skeleton.Delimited() ? cell.plain : cell.fitted;
+                output.skeleton.Fill(output.buffer, output.block, column, text, {}, cell.number);
+            }
+        }
+
+        /**
+         * @brief Write the text of the current cell into its slot in the open row of each output.
+         */
+        void FillCell(const CellText& cell, std::string_view style) {
+
+            FillCell(cell, style, static_cast<std::size_t>(m_columnIndex));
+        }
+
+        /**
+         * @brief Append a part of the layout, e.g. the header block, to the row buffer of each output.
+         */
+        void AppendPart(const std::string& (detail::RowSkeleton::*part)() const) {
+
+            m_rowBuffer += (m_skeleton.*part)();
+            for (auto& output : m_outputs) output.buffer += (output.skeleton.*part)();
+        }
+
+        /**
+         * @brief Add a style rule for a column.
+         */
+        void AddStyleRule(int column, detail::StyleSheet::Rule rule) {
+
+            if (column < 0 || column >= GetColumnCount()) {
+                throw std::invalid_argument("Column index is out of range");
+            }
+
+            m_styles.Add(static_cast<std::size_t>(column), std::move(rule));
+            m_styled = m_colorEnabled;
+        }
+
+        /**
+         * @brief Check that a column index is valid.
+         */
+        void CheckColumn(int column) const {
+
+            if (column < 0 || column >= GetColumnCount()) {
+                throw std::invalid_argument("Column index is out of range");
+            }
+        }
+
+        /**
+         * @brief Add a value to the aggregates of a column, if it is a number.
+         */
+        template<typename T>
+        void Accumulate(std::size_t column, const T& value) {
+
+            if constexpr(detail::IsStoredAsInteger<T> || std::is_floating_point<T>::value) {
+                if (m_aggregating) m_aggregates[column].Add(static_cast<double>(value), detail::IsStoredAsInteger<T>);
+            }
+        }
+
+        /**
+         * @brief Add a stored value to the aggregates of a column, if it is a number.
+         */
+        void AccumulateStored(std::size_t column, const detail::StoredCell& cell) {
+
+            double value;
+            if (m_aggregating && detail::StoredNumber(cell, value)) {
+                m_aggregates[column].Add(value, cell.kind == detail::StoredCell::Kind::Integer || cell.kind == detail::StoredCell::Kind::Unsigned);
+            }
+        }
+
+        /**
+         * @brief Visit the cells of the summary rows with the aggregates.
+         * @param visitRow Called with the label of each summary row, before its cells.
+         * @param visitCell Called for each cell of the row, in column order, with the column, the value (NaN if the
+         * cell is blank) and whether the value is an integer. Integers are only reported as such if they fit in a
+         * long long; larger sums (e.g. of unsigned columns) are formatted as floating point numbers.
+         */
+        template<typename RowVisitor, typename CellVisitor>
+        void VisitAggregates(RowVisitor&& visitRow, CellVisitor&& visitCell) const {
+
+            static constexpr std::pair<Aggregate, std::string_view> kinds[] = {
+                {Aggregate::Count, "Count"}, {Aggregate::Sum, "Sum"}, {Aggregate::Min, "Min"}, {Aggregate::Max, "Max"}, {Aggregate::Mean, "Mean"}};
+            constexpr auto blank = std::numeric_limits<double>::quiet_NaN();
+            auto fitsInteger     = [](double value) { return value >= -0x1p63 && value < 0x1p63; };
+
+            for (const auto& [kind, label] : kinds) {
+                auto bit = static_cast<unsigned>(kind);
+                if (std::none_of(m_aggregates.begin(), m_aggregates.end(), [&](const auto& a) { return (a.Kinds() & bit) != 0; })) continue;
+
+                visitRow(label);
+                for (std::size_t column = 0; column < m_aggregates.size(); ++column) {
+                    const auto& aggregate = m_aggregates[column];
+                    if ((aggregate.Kinds() & bit) == 0 || (kind != Aggregate::Count && aggregate.Count() == 0)) {
+                        visitCell(column, blank, false);
+                        continue;
+                    }
+
+                    switch (kind) {
+                        case Aggregate::Count:
+                            visitCell(column, static_cast<double>(aggregate.Count()), true);
+                            break;
+                        case Aggregate::Sum:
+                            visitCell(column, aggregate.Sum(), aggregate.Integral() && fitsInteger(aggregate.Sum()));
+                            break;
+                        case Aggregate::Min:
+                            visitCell(column, aggregate.Min(), aggregate.Integral() && fitsInteger(aggregate.Min()));
+                            break;
+                        case Aggregate::Max:
+                            visitCell(column, aggregate.Max(), aggregate.Integral() && fitsInteger(aggregate.Max()));
+                            break;
+                        default:
+                            visitCell(column, aggregate.Mean(), false);
+                            break;
+                    }
+                }
+            }
+
+            for (auto percentile : m_percentiles) {
+                char label[32] = "P";
+                auto result    = std::to_chars(label + 1, label + sizeof(label), percentile);
+                visitRow(std::string_view(label, static_cast<std::size_t>(result.ptr - label)));
+                for (std::size_t column = 0; column < m_aggregates.size(); ++column) {
+                    const auto& aggregate = m_aggregates[column];
+                    auto        tracked   = aggregate.HasQuantile(percentile / 100);
+                    visitCell(column, tracked ? aggregate.Quantile(percentile / 100) : blank, false);
+                }
+            }
+        }
+
+        /**
+         * @brief Get the column that holds the labels of the summary rows: the first column without aggregates.
+         * @return The column index, or the number of columns if all columns have aggregates.
+         */
+        std::size_t AggregateLabelColumn() const {
+
+            for (std::size_t column = 0; column < m_aggregates.size(); ++column)
+                if (m_aggregates[column].Kinds() == 0 && !HasPercentiles(column)) return column;
+            return m_aggregates.size();
+        }
+
+        /**
+         * @brief Widen the measured column widths to fit the summary rows, before the widths are resolved.
+         */
+        void MeasureAggregates() {
+
+            auto labelColumn = AggregateLabelColumn();
+            VisitAggregates(
+                [&](std::string_view label) {
+                    if (labelColumn == m_aggregates.size()) return;
+                    m_measuredWidths[labelColumn] = std::max(m_measuredWidths[labelColumn], static_cast<int>(label.size()));
+                },
+                [&](std::size_t column, double value, bool integral) {
+                    if (std::isnan(value)) return;
+
+                    const auto& format = m_numberFormats[column];
+                    if (!format.IsDefault()) {
+                        auto width = integral ? format.NaturalWidth(static_cast<long long>(value)) : format.NaturalWidth(value);
+                        m_measuredWidths[column] = std::max(m_measuredWidths[column], width);
+                        return;
+                    }
+
+                    detail::NumberBuffer buffer;
+                    auto result = integral ? std::to_chars(buffer.data(), buffer.data() + buffer.size(), static_cast<long long>(value))
+                                           : std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::fixed);
+                    auto width  = result.ec == std::errc() ? static_cast<int>(result.ptr - buffer.data()) : static_cast<int>(buffer.size());
+                    m_measuredWidths[column] = std::max(m_measuredWidths[column], width);
+                });
+        }
+
+        /**
+         * @brief Append the summary rows with the aggregates to the row buffers, and start the aggregates over.
+         */
+        void AppendAggregates() {
+
+            AppendPart(&detail::RowSkeleton::Divider);
+
+            auto                 labelColumn = AggregateLabelColumn();
+            std::string_view     rowLabel;
+            detail::NumberBuffer number;
+            detail::NumberBuffer plain;
+            VisitAggregates(
+                [&](std::string_view label) {
+                    rowLabel = label;
+                    OpenRow();
+                },
+                [&](std::size_t column, double value, bool integral) {
+                    CellText cell;
+                    if (column == labelColumn)
+                        cell = {detail::TruncateToWidth(rowLabel, static_cast<std::size_t>(m_columnWidths[column])), rowLabel, false};
+                    else if (integral)
+                        cell = FormatCell(number, plain, static_cast<long long>(value), column);
+                    else if (!std::isnan(value))
+                        cell = FormatCell(number, plain, value, column);
+                    FillCell(cell, {}, column);
+                });
+
+            for (auto& aggregate : m_aggregates) aggregate.Clear();
+        }
+
+        /**
+         * @brief Does a column track any percentiles?
+         */
+        bool HasPercentiles(std::size_t column) const {
+
+            const auto& aggregate = m_aggregates[column];
+            return std::any_of(m_percentiles.begin(), m_percentiles.end(), [&](double percentile) { return aggregate.HasQuantile(percentile / 100); });
+        }
+
+        /**
+         * @brief Find out whether the output supports colors, and enable styling accordingly.
+         */
+        void DetectColor() {
+
+            if (const auto* streamSink = dynamic_cast<const StreamSink*>(&m_sink)) {
+                m_colorSupported = rang::rang_implementation::supportsColor() &&
+                                   rang::rang_implementation::isTerminal(streamSink->GetStream().rdbuf());
+            }
+            SetStyling(rang::rang_implementation::controlMode());
+        }
+
+        /**
+         * @brief Close the current cell; if it was the last cell in the row, write the row to the output.
+         */
+        void EndCell() {
+
+            if (m_columnIndex == GetColumnCount() - 1) {
+                m_rowIndex    = m_rowIndex + 1;
+                m_columnIndex = 0;
+                ++m_tableRow;
+                WriteBuffer();
+            }
+            else {
+                ++m_columnIndex;
+            }
+        }
+
+        /**
+         * @brief Write the contents of the row buffer to the sink in one go, and clear the buffer.
+         */
+        void WriteBuffer() {
+
+            if (!m_rowBuffer.empty()) WriteToSink(m_sink, m_rowBuffer.data(), m_rowBuffer.size());
+            m_rowBuffer.clear();
+            for (auto& output : m_outputs) {
+                if (!output.buffer.empty()) WriteToSink(*output.sink, output.buffer.data(), output.buffer.size());
+                output.buffer.clear();
+            }
+        }
+
+        /**
+         * @brief Write to a sink, counting the bytes, the writes and the time taken.
+         */
+        void WriteToSink(Sink& sink, const char* data, std::size_t size) {
+
+            if constexpr(detail::StatisticsEnabled) {
+                auto start = std::chrono::steady_clock::now();
+                sink.Write(data, size);
+                m_statistics.writingTime += std::chrono::steady_clock::now() - start;
+                m_statistics.bytes += size;
+                ++m_statistics.writes;
+            }
+            else {
+                sink.Write(data, size);
+            }
+        }
+
+        /**
+         * @brief Flush a sink, counting the flushes and the time taken.
+         */
+        void FlushSink(Sink& sink) {
+
+            if constexpr(detail::StatisticsEnabled) {
+                auto start = std::chrono::steady_clock::now();
+                sink.Flush();
+                m_statistics.writingTime += std::chrono::steady_clock::now() - start;
+                ++m_statistics.flushes;
+            }
+            else {
+                sink.Flush();
+            }
+        }
+
+        /**
+         * @brief Count a printed cell in the statistics of its column.
+         */
+        void CountCell(std::size_t column, std::string_view text, bool number) {
+
+            if constexpr(detail::StatisticsEnabled) {
+                detail::CountCell(m_statistics.columns[column],
+                                  text,
+                                  m_columnWidths[column],
+                                  number,
+                                  m_wrapColumns[column] != 0 && m_format == OutputFormat::Boxed,
+                                  m_numberFormats[column].Marker());
+            }
+        }
+
+        /**
+         * @brief Get the per-column statistics for detail::AppendStoredRows; nullptr when they are not collected.
+         */
+        std::vector<TableStatistics::Column>* CellStatistics() {
+
+            return detail::StatisticsEnabled ? &m_statistics.columns : nullptr;
+        }
+
+        /**
+         * @brief Is a cell of type T formatted as a number?
+         */
+        template<typename T>
+        static constexpr bool IsNumber = detail::IsStoredAsInteger<T> || std::is_floating_point<T>::value;
+
+        /**
+         * @brief Format a value for a column, in the forms the outputs need.
+         * @param fitted Scratch buffer for the number fitted to the column.
+         * @param plain Scratch buffer for the number in full.
+         */
+        template<typename T>
+        CellText FormatCell(detail::NumberBuffer& fitted, detail::NumberBuffer& plain, const T& value, std::size_t column) {
+
+            if constexpr(IsNumber<T>) {
+                CellText cell;
+                cell.number = true;
+                if (m_fittedCells) cell.fitted = m_formatter.Format(fitted, value, m_columnWidths[column], m_numberFormats[column]);
+                if (m_plainCells) cell.plain = detail::FormatShortest(plain, value);
+                return cell;
+            }
+            else {
+                auto text = m_formatter.Format(fitted, value, m_columnWidths[column], m_numberFormats[column]);
+                return {text, text, false};
+            }
+        }
+
+        /**
+         * @brief Format a stored cell for a column, in the forms the outputs need; see FormatCell.
+         */
+        CellText FormatStored(detail::NumberBuffer&     fitted,
+                              detail::NumberBuffer&     plain,
+                              const detail::RowStore&   store,
+                              const detail::StoredCell& stored,
+                              std::size_t               column) {
+
+            if (stored.kind == detail::StoredCell::Kind::Text) return {store.Text(stored), store.Text(stored), false};
+
+            CellText cell;
+            cell.number = true;
+            if (m_fittedCells) cell.fitted = detail::FormatStoredCell(m_formatter, fitted, store, stored, m_columnWidths[column], m_numberFormats[column]);
+            if (m_plainCells) cell.plain = detail::FormatStoredPlain(plain, store, stored);
+            return cell;
+        }
+
+        /**
+         * @brief Get the text of a cell as written to the main output.
+         */
+        std::string_view MainText(const CellText& cell) const {
+
+            return m_delimited ? cell.plain : cell.fitted;
+        }
+
+        /**
+         * @brief Measures the time spent in the public member functions, for the statistics.
+         * @details Scopes nest; only the outermost one reads the clock, on entry and on exit, so every call is
+         * timed on its own and the caller's work between calls (e.g. between the cells of a row) is not counted.
+         */
+        class BusyScope {
+        public:
+            explicit BusyScope(TablePrinter& printer)
+                    : m_printer(printer) {
+
+                if constexpr(detail::StatisticsEnabled) {
+                    if (m_printer.m_busyDepth++ == 0) m_printer.m_busyStart = std::chrono::steady_clock::now();
+                }
+            }
+
+            ~BusyScope() {
+
+                if constexpr(detail::StatisticsEnabled) {
+                    if (--m_printer.m_busyDepth == 0)
+                        m_printer.m_busyTime += std::chrono::steady_clock::now() - m_printer.m_busyStart;
+                }
+            }
+
+            BusyScope(const BusyScope&)            = delete;
+            BusyScope& operator=(const BusyScope&) = delete;
+
+        private:
+            TablePrinter& m_printer; /**< the printer being timed */
+        };
+
+        std::unique_ptr<Sink>    m_ownedSink; /**< the sink, when constructed with a stream */
+        Sink&                    m_sink; /**< */
+        std::vector<std::string> m_columnTitles; /**< */
+        std::vector<int>         m_columnWidths; /**< */
+        std::string              m_columnSeparator; /**< */
+
+        std::string           m_rowBuffer; /**< the row currently being assembled; reused between rows */
+        detail::CellFormatter m_formatter; /**< formats cell values into the row buffer */
+        detail::RowSkeleton   m_skeleton; /**< the layout compiled into a blank row, borders and header */
+        detail::RowBlock      m_block; /**< the lines of the open row in the row buffer */
+        std::vector<char>     m_wrapColumns; /**< are the cells of each column wrapped? */
+        bool                  m_wrapNewColumns{false}; /**< are the cells of columns added later wrapped? */
+
+        /**
+         * @brief A title or header requested while the column widths were still being measured.
+         */
+        struct Deferred {
+            enum class Kind { Title, Header };
+
+            Kind        kind; /**< what to print */
+            std::size_t titleOffset; /**< the offset of the text of a title in m_deferredTitles */
+            std::size_t titleLength; /**< the length of the text of a title */
+            std::size_t row; /**< the number of buffered rows preceding it */
+        };
+
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> m_arena; /**< the arena, when set up with UseArena */
+
+        std::vector<int>      m_maxWidths; /**< the widths given to AddColumn */
+        std::vector<int>      m_measuredWidths; /**< the widest cell in each column among the buffered rows */
+        detail::RowStore      m_rows; /**< rows buffered while measuring the column widths */
+        std::pmr::vector<Deferred> m_deferred; /**< titles and headers buffered while measuring the column widths */
+        std::pmr::string           m_deferredTitles; /**< the text of the deferred titles */
+        std::size_t           m_bufferedRows{0}; /**< the number of complete rows in m_rows */
+        std::size_t           m_sampleRows{0}; /**< the number of rows to measure; zero for all */
+        bool                  m_autoWidth{false}; /**< fit the column widths to the content? */
+        bool                  m_widthsPending{false}; /**< are rows being buffered, for measuring or sorting? */
+        bool                  m_widthsFitted{false}; /**< have the widths of the current table been fitted? */
+
+        /**
+         * @brief A column the rows are sorted by.
+         */
+        struct SortColumn {
+            std::size_t column; /**< the column index */
+            SortOrder   order; /**< the sort order */
+        };
+
+        std::vector<SortColumn>  m_sortColumns; /**< the columns the rows are sorted by, most significant first */
+        std::size_t              m_topRows{0}; /**< the number of top rows to keep; zero for all */
+        std::vector<std::size_t> m_topHeap; /**< the rows kept by a top-K table, with the last of them on top */
+        std::vector<std::size_t> m_rowOrder; /**< the buffered rows in sorted order, while printing them */
+
+        unsigned                                            m_formattingThreads{1}; /**< threads for formatting buffered rows */
+        std::size_t                                         m_parallelMinRows{65536}; /**< smallest table formatted in parallel */
+        std::vector<std::unique_ptr<detail::CellFormatter>> m_workerFormatters; /**< one formatter per formatting thread */
+        std::vector<std::string>                            m_chunkBuffers; /**< one output buffer per formatting thread */
+
+        Row m_windowRow; /**< the row being printed by PrintWindow */
+
+        /**
+         * @brief An additional output of the table, in a format of its own; see AddOutput.
+         */
+        struct Output {
+            std::unique_ptr<Sink> ownedSink; /**< the sink, when added with a stream */
+            Sink*                 sink; /**< the sink */
+            OutputFormat          format; /**< the output format */
+            detail::RowSkeleton   skeleton{}; /**< the layout, compiled for the format */
+            std::string           buffer{}; /**< the rows waiting to be written */
+            detail::RowBlock      block{}; /**< the lines of the open row in the buffer */
+        };
+
+        OutputFormat        m_format{OutputFormat::Boxed}; /**< the format of the main output */
+        std::vector<Output> m_outputs; /**< the additional outputs */
+        bool                m_delimited{false}; /**< is the main output delimited? See detail::IsDelimited */
+        bool                m_fittedCells{true}; /**< does any output need the cells fitted to the columns? */
+        bool                m_plainCells{false}; /**< does any output need the numbers in full? */
+
+        std::vector<detail::NumberFormat> m_numberFormats; /**< the number format of each column */
+        std::vector<char>                 m_alignment; /**< the alignment of each column, from its number format */
+
+        std::vector<detail::ColumnAggregate> m_aggregates; /**< the running aggregates of each column */
+        std::vector<double>                  m_percentiles; /**< the percentiles shown in the footer, in ascending order */
+        bool                                 m_aggregating{false}; /**< are any aggregates shown? */
+
+        std::vector<std::string>                m_columnText; /**< formatted cells of each column, for PrintColumns */
+        std::vector<std::vector<std::uint32_t>> m_columnEnds; /**< end offset of each cell in m_columnText */
+        std::vector<std::vector<std::string_view>> m_columnStyles; /**< the style of each cell in m_columnText */
+        std::vector<std::string>                m_columnOtherText; /**< the numbers of each column in the form only the added outputs need */
+        std::vector<std::vector<std::uint32_t>> m_columnOtherEnds; /**< end offset of each cell in m_columnOtherText */
+        std::vector<char>                       m_columnNumbers; /**< are the cells of each column in m_columnText numbers? */
+
+        detail::StyleSheet m_styles; /**< the style rules */
+        std::size_t        m_tableRow{0}; /**< index of the current row within the table, for row shading */
+        bool               m_colorSupported{false}; /**< is the output a terminal that supports colors? */
+        bool               m_colorEnabled{false}; /**< are styles printed? */
+        bool               m_styled{false}; /**< are styles printed, and are there any? */
+
+        TableStatistics                                   m_statistics; /**< the statistics, when collected */
+        std::vector<std::vector<TableStatistics::Column>> m_chunkStatistics; /**< the cell statistics of each formatting thread */
+        std::chrono::steady_clock::duration               m_busyTime{}; /**< time spent in the public member functions */
+        std::chrono::steady_clock::time_point             m_busyStart{}; /**< when the outermost BusyScope was entered */
+        unsigned                                          m_busyDepth{0}; /**< the nesting depth of BusyScope */
+
+        static constexpr std::size_t s_writeBatchSize  = 64 * 1024; /**< buffer size that triggers a write in batch mode */
+        static constexpr std::size_t s_columnBlockSize = 1024; /**< number of rows formatted per block in PrintColumns */
+        static constexpr std::size_t s_parallelChunkRows = 16384; /**< number of rows formatted per chunk by each thread */
+
+        int m_rowIndex{0}; /**< index of current row */
+        int m_columnIndex{0}; /**< index of current column */
+
+        int  m_tableWidth{0}; /**< */
+        bool m_flushLeft{false}; /**< */
+    };
+
+    /**
+     * @brief A front-end that lets several threads print rows to the same TablePrinter.
+     *
+     * Usage:
+     *   trl::TablePrinter tp;
+     *   tp.AddColumn("Worker", 10);
+     *   tp.AddColumn("Status", 20);
+     *   tp.PrintHeader();
+     *   {
+     *       trl::ConcurrentTablePrinter ctp(tp);
+     *       // on any thread:
+     *       ctp.Submit("Worker 3", "Done");
+     *   }
+     *   tp.PrintFooter();
+     *
+     * Each producer builds a complete row (a trl::Row) on its own thread, and submits it through a lock-free
+     * multi-producer, single-consumer queue to a writer thread that owns the printer. Rows from one thread are
+     * printed in the order they were submitted; rows from different threads are never interleaved. While the
+     * front-end exists, the printer must not be used directly. The destructor prints all submitted rows.
+     */
+    class ConcurrentTablePrinter {
+    public:
+
+        /**
+         * @brief Constructor. Starts the writer thread.
+         * @param printer The printer to print the rows with. Its columns must already have been added.
+         */
+        explicit ConcurrentTablePrinter(TablePrinter& printer)
+                : m_printer(printer),
+                  m_columnCount(static_cast<std::size_t>(printer.GetColumnCount())),
+                  m_head(new Node),
+                  m_tail(m_head.load()) {
+
+            m_writer = std::thread([this] { WriterLoop(); });
+        }
+
+        /**
+         * @brief
+         * @param other
+         */
+        ConcurrentTablePrinter(const ConcurrentTablePrinter& other) = delete;
+
+        /**
+         * @brief
+         * @param other
+         * @return
+         */
+        ConcurrentTablePrinter& operator=(const ConcurrentTablePrinter& other) = delete;
+
+        /**
+         * @brief Destructor. Prints all submitted rows, flushes the printer and stops the writer thread.
+         */
+        ~ConcurrentTablePrinter() {
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_writerWakeup.notify_one();
+            m_writer.join();
+
+            while (auto* node = m_tail) {
+                m_tail = node->next.load();
+                delete node;
+            }
+        }
+
+        /**
+         * @brief Submit a row for printing. Can be called from any thread.
+         * @param row The row. It must hold one cell for each column.
+         */
+        void Submit(Row row) {
+
+            if (row.GetCellCount() != m_columnCount) {
+                throw std::invalid_argument("The number of cells in the row must match the number of columns");
+            }
+
+            auto* node = new Node;
+            node->row  = std::move(row);
+
+            // Counted before the node is queued, so a Flush that starts after this call returns waits for the row.
+            m_submitted.fetch_add(1);
+            auto* previous = m_head.exchange(node);
+            previous->next.store(node);
+
+            // The writer only needs waking if it has gone to sleep; otherwise no lock is taken.
+            if (m_writerSleeping.load()) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_writerWakeup.notify_one();
+            }
+        }
+
+        /**
+         * @brief Build a row from the given values and submit it for printing. Can be called from any thread.
+         * @param values The values of the cells; one for each column.
+         */
+        template<typename... Ts>
+        void Submit(const Ts&... values) {
+
+            Row row;
+            (row << ... << values);
+            Submit(std::move(row));
+        }
+
+        /**
+         * @brief Wait until all rows submitted so far have been printed, and flush the printer.
+         * @details Rows whose Submit call returned before this call are printed, even if another producer is still
+         * in the middle of queueing an earlier row. If the writer thread failed to print a row, the exception is
+         * rethrown here.
+         */
+        void Flush() {
+
+            auto                         target = m_submitted.load();
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_flushTarget = std::max(m_flushTarget, target);
+            auto request  = ++m_flushRequested;
+            m_writerWakeup.notify_one();
+            m_flushDone.wait(lock, [&] { return m_flushCompleted >= request; });
+
+            if (m_error) {
+                auto error = m_error;
+                m_error    = nullptr;
+                std::rethrow_exception(error);
+            }
+        }
+
+    private:
+
+        /**
+         * @brief A node in the queue. The queue always holds one node whose row has already been taken.
+         */
+        struct Node {
+            std::atomic<Node*> next{nullptr}; /**< the next node in the queue */
+            Row                row; /**< the submitted row */
+        };
+
+        /**
+         * @brief Take the oldest row from the queue. Only called from the writer thread.
+         * @param row Receives the row.
+         * @return true if a row was taken, false if the queue was empty.
+         */
+        bool Pop(Row& row) {
+
+            auto* next = m_tail->next.load();
+            if (!next) return false;
+
+            row = std::move(next->row);
+            delete m_tail;
+            m_tail = next;
+            return true;
+        }
+
+        /**
+         * @brief The loop of the writer thread.
+         */
+        void WriterLoop() {
+
+            Row row;
+            while (true) {
+
+                if (Pop(row)) {
+                    try {
+                        m_printer.PrintRow(row);
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if (!m_error) m_error = std::current_exception();
+                    }
+                    ++m_printed;
+                    continue;
+                }
+
+                // A flush (or stop) is only done once every row counted before it has been printed. Until then, the
+                // queue may be empty because a producer has yet to link its row; linking it wakes the writer.
+                std::unique_lock<std::mutex> lock(m_mutex);
+                auto flushDue = m_flushCompleted < m_flushRequested && m_printed >= m_flushTarget;
+                auto stopDue  = m_stop && m_printed >= m_submitted.load();
+                if (flushDue || stopDue) {
+                    lock.unlock();
+                    try {
+                        m_printer.Flush();
+                    }
+                    catch (...) {
+                        lock.lock();
+                        if (!m_error) m_error = std::current_exception();
+                        lock.unlock();
+                    }
+                    lock.lock();
+
+                    if (stopDue) return;
+                    m_flushCompleted = m_flushRequested;
+                    m_flushDone.notify_all();
+                    continue;
+                }
+
+                // Announce that the writer is going to sleep, then check the queue once more before waiting. A
+                // producer links its row before checking the flag, so either the row is seen here, or the producer
+                // sees the flag and notifies under the lock, which is held until the wait has begun.
+                m_writerSleeping.store(true);
+                if (!m_tail->next.load()) m_writerWakeup.wait(lock);
+                m_writerSleeping.store(false);
+            }
+        }
+
+        TablePrinter&      m_printer; /**< the printer, owned by the writer thread */
+        const std::size_t  m_columnCount; /**< the number of columns in the printer */
+        std::atomic<Node*> m_head; /**< the most recently submitted node; producers push here */
+        Node*              m_tail; /**< the node preceding the oldest unprinted row; owned by the writer */
+
+        std::thread                m_writer; /**< the writer thread */
+        std::mutex                 m_mutex; /**< protects the members below, and the writer's sleep */
+        std::condition_variable    m_writerWakeup; /**< wakes the writer thread */
+        std::condition_variable    m_flushDone; /**< signals completed flushes */
+        std::atomic<bool>          m_writerSleeping{false}; /**< is the writer about to wait on m_writerWakeup? */
+        std::atomic<std::uint64_t> m_submitted{0}; /**< the number of rows submitted, counted before queueing */
+        std::uint64_t              m_printed{0}; /**< the number of rows taken from the queue; owned by the writer */
+        std::uint64_t              m_flushTarget{0}; /**< the number of rows to print before completing the flushes */
+        std::uint64_t              m_flushRequested{0}; /**< the number of flushes requested */
+        std::uint64_t              m_flushCompleted{0}; /**< the number of flushes completed */
+        std::exception_ptr         m_error; /**< the first exception thrown on the writer thread */
+        bool                       m_stop{false}; /**< has the destructor been called? */
+    };
+
+    /**
+     * @brief A table that is redrawn in place on a terminal, for dashboards.
+     *
+     * Usage:
+     *   trl::TablePrinter tp;
+     *   tp.AddColumn("Worker", 10);
+     *   tp.AddColumn("Jobs", 8);
+     *
+     *   trl::LiveTable live(tp, 200);
+     *   live.SetMaxFrameRate(10);
+     *   while (running) {
+     *       live.SetRow(3, "Worker 3", jobs);
+     *       live.Refresh();
+     *   }
+     *
+     * The columns, widths, separator, alignment and sink are taken from the printer. The first Refresh() draws
+     * the whole table; after that, the last drawn frame is kept, and a refresh only emits ANSI cursor movements
+     * and the new text of the cells whose content has changed, in one write. With SetMaxFrameRate, refreshes
+     * that come too soon after the previous frame are skipped, and their changes are coalesced into the next
+     * frame. The cursor is left below the table between frames. The output must be a terminal that understands
+     * ANSI escape sequences.
+     */
+    class LiveTable {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param printer The printer providing the layout and the sink.
+         * @param rowCount The number of rows in the table.
+         */
+        LiveTable(TablePrinter& printer, std::size_t rowCount)
+                : m_printer(printer) {
+
+            if (printer.GetOutputFormat() != OutputFormat::Boxed) {
+                throw std::logic_error("A live table must be printed as a boxed table");
+            }
+
+            SetRowCount(rowCount);
+        }
+
+        /**
+         * @brief Change the number of rows. The whole table is redrawn by the next refresh.
+         * @param rowCount The number of rows in the table.
+         */
+        void SetRowCount(std::size_t rowCount) {
+
+            auto cellCount = rowCount * ColumnCount();
+            if (rowCount != m_rowCount) m_fullRedraw = true;
+            m_rowCount = rowCount;
+
+            m_cells.resize(cellCount);
+            m_shown.resize(cellCount);
+            m_dirty.assign(cellCount, 0);
+            m_dirtyCells.clear();
+            for (std::size_t index = 0; index < cellCount; ++index) {
+                if (m_cells[index].empty()) m_cells[index].assign(static_cast<std::size_t>(Width(index)), ' ');
+            }
+        }
+
+        /**
+         * @brief Get the number of rows.
+         * @return The number of rows.
+         */
+        std::size_t GetRowCount() const {
+
+            return m_rowCount;
+        }
+
+        /**
+         * @brief Limit how often the table is redrawn.
+         * @param framesPerSecond The maximum number of frames per second; zero (the default) means no limit.
+         */
+        void SetMaxFrameRate(double framesPerSecond) {
+
+            m_frameInterval = framesPerSecond > 0 ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                            std::chrono::duration<double>(1.0 / framesPerSecond))
+                                                  : std::chrono::steady_clock::duration::zero();
+        }
+
+        /**
+         * @brief Set the value of a cell. Nothing is printed until the next refresh.
+         * @details The text is cut to the column width, and control characters such as line breaks are shown as
+         * spaces, as every row of a live table is one line, wrapped columns or not.
+         * @tparam T The type of the value.
+         * @param row The row index.
+         * @param column The column index.
+         * @param value The value.
+         */
+        template<typename T>
+        void SetCell(std::size_t row, int column, const T& value) {
+
+            if (row >= m_rowCount || column < 0 || column >= static_cast<int>(ColumnCount())) {
+                throw std::out_of_range("Cell is outside the live table");
+            }
+
+            TablePrinter::BusyScope busy(m_printer);
+            auto                    index = row * ColumnCount() + static_cast<std::size_t>(column);
+            auto                    width = Width(index);
+
+            // Cells are cut to the column width, and control characters (line breaks, tabs, escape sequences) are
+            // blanked, so every row stays one line and an update can never disturb the rest of the table.
+            m_scratch.clear();
+            auto alignment = m_printer.m_alignment[static_cast<std::size_t>(column)];
+            auto flushLeft = alignment == 0 ? m_printer.m_flushLeft : alignment == '<';
+            m_printer.m_formatter.Append(m_scratch, value, width, flushLeft, m_printer.m_numberFormats[static_cast<std::size_t>(column)]);
+            for (auto& c : m_scratch) {
+                if (static_cast<unsigned char>(c) < 0x20 || c == 0x7f) c = ' ';
+            }
+            m_scratch.resize(detail::TruncateToWidth(m_scratch, static_cast<std::size_t>(width)).size());
+            m_scratch.append(static_cast<std::size_t>(width) - detail::DisplayWidth(m_scratch), ' ');
+
+            auto& cell = m_cells[index];
+            if (cell == m_scratch) return;
+            cell.assign(m_scratch);
+            if (!m_dirty[index]) {
+                m_dirty[index] = 1;
+                m_dirtyCells.push_back(index);
+            }
+        }
+
+        /**
+         * @brief Set the values of all cells in a row. Nothing is printed until the next refresh.
+         * @param row The row index.
+         * @param values The values; one for each column.
+         */
+        template<typename... Ts>
+        void SetRow(std::size_t row, const Ts&... values) {
+
+            if (sizeof...(Ts) != ColumnCount()) {
+                throw std::invalid_argument("The number of values must match the number of columns");
+            }
+
+            int column = 0;
+            (SetCell(row, column++, values), ...);
+        }
+
+        /**
+         * @brief Print the changes since the last frame, unless the previous frame was drawn too recently.
+         * @return true if a frame was printed; false if it was skipped (the changes are kept for the next frame).
+         */
+        bool Refresh() {
+
+            auto now = std::chrono::steady_clock::now();
+            if (m_frameCount > 0 && now - m_lastFrame < m_frameInterval) return false;
+
+            TablePrinter::BusyScope busy(m_printer);
+            if (m_fullRedraw)
+                DrawAll();
+            else
+                DrawChanges();
+
+            m_lastFrame = now;
+            ++m_frameCount;
+            return true;
+        }
+
+        /**
+         * @brief Redraw the whole table immediately, regardless of the frame rate limit.
+         */
+        void Redraw() {
+
+            m_fullRedraw = true;
+            m_frameCount = 0;
+            Refresh();
+        }
+
+        /**
+         * @brief Get the number of frames printed.
+         * @return The number of frames.
+         */
+        std::uint64_t GetFrameCount() const {
+
+            return m_frameCount;
+        }
+
+    private:
+
+        std::size_t ColumnCount() const {
+
+            return static_cast<std::size_t>(m_printer.GetColumnCount());
+        }
+
+        int Width(std::size_t index) const {
+
+            return m_printer.m_columnWidths[index % ColumnCount()];
+        }
+
+        /**
+         * @brief The number of lines drawn on screen: header block, rows and footer.
+         */
+        std::size_t LineCount() const {
+
+            return m_drawnLines;
+        }
+
+        /**
+         * @brief Append an ANSI control sequence with a numeric parameter.
+         */
+        void AppendControl(std::size_t count, char command) {
+
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), count);
+            m_frame += "\x1b[";
+            m_frame.append(digits, static_cast<std::size_t>(result.ptr - digits));
+            m_frame += command;
+        }
+
+        /**
+         * @brief Draw the whole table, replacing the previously drawn one (if any).
+         */
+        void DrawAll() {
+
+            m_frame.clear();
+            if (m_drawn) {
+                AppendControl(LineCount(), 'A');
+                m_frame += "\r\x1b[J";
+            }
+
+            const auto& skeleton = m_printer.m_skeleton;
+            auto        columns  = ColumnCount();
+            auto        start    = m_frame.size();
+            m_frame += skeleton.Header();
+            for (std::size_t row = 0; row < m_rowCount; ++row) {
+                skeleton.Open(m_frame, m_block);
+                for (std::size_t column = 0; column < columns; ++column) skeleton.Fill(m_frame, m_block, column, m_cells[row * columns + column]);
+            }
+            m_frame += skeleton.Line();
+
+            // The lines are counted as drawn, so the cursor movements of later frames match the screen.
+            m_headerLines = static_cast<std::size_t>(std::count(skeleton.Header().begin(), skeleton.Header().end(), '\n'));
+            m_drawnLines  = static_cast<std::size_t>(std::count(m_frame.begin() + static_cast<std::ptrdiff_t>(start), m_frame.end(), '\n'));
+
+            m_shown = m_cells;
+            for (auto index : m_dirtyCells) m_dirty[index] = 0;
+            m_dirtyCells.clear();
+            m_drawn      = true;
+            m_fullRedraw = false;
+            Emit();
+        }
+
+        /**
+         * @brief Draw the cells that differ from the last frame, moving the cursor to each of them.
+         */
+        void DrawChanges() {
+
+            if (m_dirtyCells.empty()) return;
+
+            m_frame.clear();
+            std::sort(m_dirtyCells.begin(), m_dirtyCells.end());
+
+            auto        columns    = ColumnCount();
+            std::size_t cursorLine = LineCount(); // the cursor rests on the line below the table
+            for (auto index : m_dirtyCells) {
+
+                m_dirty[index] = 0;
+                if (m_cells[index] == m_shown[index]) continue; // changed and changed back
+                m_shown[index] = m_cells[index];
+
+                auto line = m_headerLines + index / columns;
+                if (line < cursorLine) AppendControl(cursorLine - line, 'A');
+                if (line > cursorLine) AppendControl(line - cursorLine, 'B');
+                cursorLine = line;
+
+                AppendControl(m_printer.m_skeleton.Position(index % columns) + 1, 'G'); // one-based
+                m_frame += m_cells[index];
+            }
+            m_dirtyCells.clear();
+
+            if (m_frame.empty()) return;
+            AppendControl(LineCount() - cursorLine, 'B');
+            m_frame += '\r';
+            Emit();
+        }
+
+        /**
+         * @brief Write the frame to the sink in one go, and flush.
+         */
+        void Emit() {
+
+            m_printer.WriteToSink(m_printer.m_sink, m_frame.data(), m_frame.size());
+            m_printer.FlushSink(m_printer.m_sink);
+        }
+
+        TablePrinter&                         m_printer; /**< the printer providing the layout and the sink */
+        std::size_t                           m_rowCount{0}; /**< the number of rows */
+        std::size_t                           m_headerLines{0}; /**< the number of lines above the first row on screen */
+        std::size_t                           m_drawnLines{0}; /**< the number of lines on screen */
+        std::vector<std::string>              m_cells; /**< the current text of each cell, padded to the column width */
+        std::vector<std::string>              m_shown; /**< the text of each cell in the last frame */
+        std::vector<std::uint8_t>             m_dirty; /**< has the cell been set since the last frame? */
+        std::vector<std::size_t>              m_dirtyCells; /**< the indices of the dirty cells */
+        std::string                           m_scratch; /**< scratch buffer for formatting cells */
+        std::string                           m_frame; /**< the frame being assembled */
+        detail::RowBlock                      m_block; /**< the lines of the row being drawn */
+        std::chrono::steady_clock::duration   m_frameInterval{}; /**< the shortest time between frames */
+        std::chrono::steady_clock::time_point m_lastFrame{}; /**< when the last frame was printed */
+        std::uint64_t                         m_frameCount{0}; /**< the number of frames printed */
+        bool                                  m_drawn{false}; /**< has the table been drawn? */
+        bool                                  m_fullRedraw{true}; /**< must the next frame redraw everything? */
+    };
+
+    /**
+     * @brief Pages through a DataSource, printing one page at a time.
+     *
+     * Usage:
+     *   trl::Pager pager(tp, source, 50);
+     *   pager.Print();          // the first page
+     *   while (pager.Next())    // or Previous(), First(), Last(), GoTo(page)
+     *       pager.Print();
+     *
+     * Only the rows of the page being printed are fetched from the source. The number of rows is read from the
+     * source when navigating, so the source may grow while it is being browsed.
+     */
+    class Pager {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param printer The printer to print the pages with; its columns must match the source.
+         * @param source The data source.
+         * @param pageSize The number of rows per page.
+         */
+        Pager(TablePrinter& printer, const DataSource& source, std::size_t pageSize)
+                : m_printer(printer),
+                  m_source(source),
+                  m_pageSize(pageSize) {
+
+            if (pageSize == 0) {
+                throw std::invalid_argument("Page size has to be > 0");
+            }
+        }
+
+        /**
+         * @brief Get the number of pages; an empty source has one empty page.
+         * @return The number of pages.
+         */
+        std::size_t GetPageCount() const {
+
+            return std::max<std::size_t>((m_source.GetRowCount() + m_pageSize - 1) / m_pageSize, 1);
+        }
+
+        /**
+         * @brief Get the current page.
+         * @return The index of the current page, counted from zero.
+         */
+        std::size_t GetPage() const {
+
+            return m_page;
+        }
+
+        /**
+         * @brief Get the index of the first row on the current page.
+         * @return The row index.
+         */
+        std::size_t GetFirstRow() const {
+
+            return m_page * m_pageSize;
+        }
+
+        /**
+         * @brief Get one past the index of the last row on the current page.
+         * @return The row index.
+         */
+        std::size_t GetLastRow() const {
+
+            return std::min(GetFirstRow() + m_pageSize, m_source.GetRowCount());
+        }
+
+        /**
+         * @brief Go to a page.
+         * @param page The index of the page; limited to the last page.
+         */
+        void GoTo(std::size_t page) {
+
+            m_page = std::min(page, GetPageCount() - 1);
+        }
+
+        /**
+         * @brief Go to the first page.
+         */
+        void First() {
+
+            m_page = 0;
+        }
+
+        /**
+         * @brief Go to the last page.
+         */
+        void Last() {
+
+            m_page = GetPageCount() - 1;
+        }
+
+        /**
+         * @brief Go to the next page, unless this is the last page.
+         * @return true if the page changed.
+         */
+        bool Next() {
+
+            if (m_page + 1 >= GetPageCount()) return false;
+            ++m_page;
+            return true;
+        }
+
+        /**
+         * @brief Go to the previous page, unless this is the first page.
+         * @return true if the page changed.
+         */
+        bool Previous() {
+
+            if (m_page == 0) return false;
+            --m_page;
+            return true;
+        }
+
+        /**
+         * @brief Print the current page, with a header and a footer.
+         */
+        void Print() {
+
+            m_printer.PrintHeader();
+            m_printer.PrintWindow(m_source, GetFirstRow(), GetLastRow());
+            m_printer.PrintFooter();
+        }
+
+    private:
+        TablePrinter&     m_printer; /**< the printer */
+        const DataSource& m_source; /**< the data source */
+        std::size_t       m_pageSize; /**< the number of rows per page */
+        std::size_t       m_page{0}; /**< the index of the current page */
+    };
+
+    /**
+     * @brief Describes a column in a StaticTablePrinter: the type of the values in the column and its width.
+     * @tparam T The type of the values in the column.
+     * @tparam Width The width of the column.
+     */
+    template<typename T, int Width>
+    struct Column {
+        static_assert(Width >= 4, "Column width has to be >= 4");
+
+        using value_type     = T; /**< the type of the values in the column */
+        using parameter_type = typename detail::ColumnParameter<T>::type; /**< the type PrintRow takes the values as */
+        static constexpr int width = Width; /**< the width of the column */
+    };
+
+    /**
+     * @brief Print a pretty table with a layout that is fixed at compile time.
+     *
+     * Usage:
+     *   trl::StaticTablePrinter<trl::Column<std::string, 25>, trl::Column<int, 5>, trl::Column<double, 9>>
+     *       tp({"Name", "Age", "Allowance"});
+     *
+     *   tp.PrintHeader();
+     *   tp.PrintRow("Dat Chu", 25, 1254.36);
+     *   tp.PrintRow(std::make_tuple("John Doe", 26, -0.5));
+     *   tp.PrintFooter();
+     *
+     * The column types and widths are template parameters, so the formatting of each cell, the padding
+     * and the position of the separators are resolved at compile time, and a whole row is written from
+     * its values in one call. The formatting rules are the same as for TablePrinter.
+     *
+     * @tparam Columns The column descriptions, as instantiations of trl::Column.
+     */
+    template<typename... Columns>
+    class StaticTablePrinter {
+        static_assert(sizeof...(Columns) > 0, "A table needs at least one column");
+
+    public:
+        /**
+         * @brief The number of columns in the table.
+         */
+        static constexpr std::size_t column_count = sizeof...(Columns);
+
+        /**
+         * @brief A tuple holding the values of one row.
+         */
+        using row_type = std::tuple<typename Columns::value_type...>;
+
+        /**
+         * @brief Constructor.
+         * @param titles The column titles.
+         * @param output The stream to print to.
+         * @param separator The column separator.
+         */
+        explicit StaticTablePrinter(const std::array<std::string, column_count>& titles,
+                                    std::ostream&                                output    = std::cout,
+                                    const std::string&                           separator = "|")
+                : m_ownedSink(std::make_unique<StreamSink>(output)),
+                  m_sink(*m_ownedSink),
+                  m_columnTitles(titles),
+                  m_columnSeparator(separator) {
+
+            m_rowBuffer.reserve(static_cast<std::size_t>(GetTableWidth()) + 2);
+        }
+
+        /**
+         * @brief Constructor.
+         * @param titles The column titles.
+         * @param sink The sink to print to.
+         * @param separator The column separator.
+         */
+        StaticTablePrinter(const std::array<std::string, column_count>& titles, Sink& sink, const std::string& separator = "|")
+                : m_sink(sink),
+                  m_columnTitles(titles),
+                  m_columnSeparator(separator) {
+
+            m_rowBuffer.reserve(static_cast<std::size_t>(GetTableWidth()) + 2);
+        }
+
+        /**
+         * @brief
+         * @param other
+         */
+        StaticTablePrinter(const StaticTablePrinter& other) = delete;
+
+        /**
+         * @brief
+         * @param other
+         * @return
+         */
+        StaticTablePrinter& operator=(const StaticTablePrinter& other) = delete;
+
+        /**
+         * @brief
+         * @return
+         */
+        static constexpr int GetColumnCount() {
+
+            return static_cast<int>(column_count);
+        }
+
+        /**
+         * @brief
+         * @return
+         */
+        int GetTableWidth() const {
+
+            return s_widthSum + static_cast<int>(column_count * detail::DisplayWidth(m_columnSeparator));
+        }
+
+        /**
+         * @brief
+         */
+        void SetFlushLeft() {
+
+            m_flushLeft = true;
+        }
+
+        /**
+         * @brief
+         */
+        void SetFlushRight() {
+
+            m_flushLeft = false;
+        }
+
+        /**
+         * @brief
+         * @param title
+         */
+        void PrintTitle(const std::string& title) {
+
+            detail::AppendTitle(m_rowBuffer, title, GetTableWidth(), s_widthSum + GetColumnCount() - 1);
+            WriteBuffer();
+        }
+
+        /**
+         * @brief
+         */
+        void PrintHeader() {
+
+            detail::AppendHeader(m_rowBuffer, m_columnTitles, s_columnWidths, m_columnSeparator, GetTableWidth(), m_flushLeft);
+            WriteBuffer();
+        }
+
+        /**
+         * @brief
+         */
+        void PrintFooter() {
+
+            detail::AppendHorizontalLine(m_rowBuffer, GetTableWidth(), '-');
+            WriteBuffer();
+        }
+
+        /**
+         * @brief Flush the sink.
+         */
+        void Flush() {
+
+            m_sink.Flush();
+        }
+
+        /**
+         * @brief Print a row.
+         * @param values The values of the cells in the row, one for each column. Strings are taken as views.
+         */
+        void PrintRow(typename Columns::parameter_type... values) {
+
+            AppendRow(std::index_sequence_for<Columns...>(), values...);
+            WriteBuffer();
+        }
+
+        /**
+         * @brief Print a row.
+         * @param row A tuple with the values of the cells in the row.
+         */
+        void PrintRow(const row_type& row) {
+
+            std::apply([this](const auto&... values) { PrintRow(values...); }, row);
+        }
+
+    private:
+
+        /**
+         * @brief Append a row to the row buffer; the column loop is unrolled at compile time.
+         */
+        template<std::size_t... Indices>
+        void AppendRow(std::index_sequence<Indices...>, typename Columns::parameter_type... values) {
+
+            m_rowBuffer += '|';
+            (AppendCell<Indices>(values), ...);
+            m_rowBuffer += "|\n";
+        }
+
+        /**
+         * @brief Append a cell, followed by a separator unless it is the last cell in the row.
+         */
+        template<std::size_t Index, typename T>
+        void AppendCell(const T& value) {
+
+            m_formatter.Append(m_rowBuffer, value, std::get<Index>(s_columnWidths), m_flushLeft);
+            if constexpr(Index + 1 < column_count) m_rowBuffer += m_columnSeparator;
+        }
+
+        /**
+         * @brief Write the contents of the row buffer to the sink in one go, and clear the buffer.
+         */
+        void WriteBuffer() {
+
+            if (!m_rowBuffer.empty()) m_sink.Write(m_rowBuffer.data(), m_rowBuffer.size());
+            m_rowBuffer.clear();
+        }
+
+        static constexpr std::array<int, column_count> s_columnWidths{Columns::width...}; /**< */
+        static constexpr int s_widthSum = (Columns::width + ...); /**< sum of the column widths */
+
+        std::unique_ptr<Sink>                  m_ownedSink; /**< the sink, when constructed with a stream */
+        Sink&                                  m_sink; /**< */
+        std::array<std::string, column_count> m_columnTitles; /**< */
+        std::string                            m_columnSeparator; /**< */
+
+        std::string           m_rowBuffer; /**< the row currently being assembled; reused between rows */
+        detail::CellFormatter m_formatter; /**< formats cell values into the row buffer */
 
-        int  m_tableWidth{0}; /**< */
         bool m_flushLeft{false}; /**< */
     };
 } // namespace trl
@@ -0,0 +1,98 @@
+//
+// Checks the aggregates printed in table footers: count, sum, mean, min/max and percentiles.
+//
+// Each case prints a table in CSV format with every aggregate and a few percentiles, reads the footer rows back,
+// and compares each with the expected value: exactly for small tables, whose percentiles are exact, and within a
+// tolerance for the percentiles of large ones. The program fails if any aggregate is off.
+//
+
+#include <TablePrinter.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Print a table of values with all aggregates, and read back the footer rows.
+     * @param values The values.
+     * @return The value of each footer row, by label.
+     */
+    std::map<std::string, double> PrintFooter(const std::vector<double>& values) {
+
+        std::ostringstream output;
+        trl::TablePrinter  printer(output);
+        printer.SetOutputFormat(trl::OutputFormat::Csv);
+        printer.AddColumn("Name", 6);
+        printer.AddColumn("Value", 10);
+        for (auto aggregate : {trl::Aggregate::Count, trl::Aggregate::Sum, trl::Aggregate::Min, trl::Aggregate::Max, trl::Aggregate::Mean})
+            printer.AddAggregate(1, aggregate);
+        for (auto percentile : {0.0, 50.0, 99.0}) printer.AddPercentile(1, percentile);
+
+        printer.PrintHeader();
+        for (auto value : values) printer << "row" << value;
+        printer.PrintFooter();
+
+        std::map<std::string, double> footer;
+        std::istringstream            lines(output.str());
+        std::string                   line;
+        while (std::getline(lines, line)) {
+            auto comma = line.find(',');
+            auto label = line.substr(0, comma);
+            if (label != "Name" && label != "row") footer[label] = std::stod(line.substr(comma + 1));
+        }
+        return footer;
+    }
+
+    /**
+     * @brief Compare the footer rows of a table with the expected values.
+     * @param name The name of the case.
+     * @param values The values of the table.
+     * @param expected The expected value of each footer row, by label.
+     * @param tolerance The tolerance of the percentiles, relative to the range of the values.
+     * @return true if every footer row is as expected.
+     */
+    bool Check(const char* name, const std::vector<double>& values, const std::map<std::string, double>& expected, double tolerance = 0.0) {
+
+        auto footer = PrintFooter(values);
+        auto range  = expected.at("Max") - expected.at("Min");
+        auto ok     = footer.size() == expected.size();
+        for (const auto& [label, value] : expected) {
+            auto found  = footer.find(label);
+            auto margin = label[0] == 'P' ? tolerance * range : 1e-9 * std::abs(value);
+            if (found == footer.end() || std::abs(found->second - value) > margin) {
+                std::printf("    %s: expected %g, got %g\n", label.c_str(), value, found == footer.end() ? NAN : found->second);
+                ok = false;
+            }
+        }
+        std::printf("%-24s %s\n", name, ok ? "ok" : "FAILED");
+        return ok;
+    }
+} // namespace
+
+int main() {
+
+    auto ok = true;
+
+    ok &= Check("three values",
+                {30, 10, 20},
+                {{"Count", 3}, {"Sum", 60}, {"Min", 10}, {"Max", 30}, {"Mean", 20}, {"P0", 10}, {"P50", 20}, {"P99", 30}});
+
+    ok &= Check("five values",
+                {932.56, 12.5, 999.04, 100.25, 500},
+                {{"Count", 5}, {"Sum", 2544.35}, {"Min", 12.5}, {"Max", 999.04}, {"Mean", 508.87}, {"P0", 12.5}, {"P50", 500}, {"P99", 999.04}});
+
+    std::vector<double> large;
+    for (int i = 0; i < 10001; ++i) large.push_back((i * 7919) % 10001 + 1);
+    ok &= Check("10001 values",
+                large,
+                {{"Count", 10001}, {"Sum", 50015001}, {"Min", 1}, {"Max", 10001}, {"Mean", 5001}, {"P0", 1}, {"P50", 5001}, {"P99", 9901}},
+                0.01);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
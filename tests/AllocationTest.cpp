@@ -0,0 +1,216 @@
+//
+// Checks that printing rows allocates nothing once a printer has reached its steady state.
+//
+// Each case sets up a printer, prints enough rows to let its buffers reach their steady state size, and then
+// prints more rows while counting calls to operator new. The program fails if any case allocates.
+//
+
+#include <TablePrinter.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//======================================================================================================================
+// Allocation counting
+//======================================================================================================================
+
+namespace
+{
+    std::atomic<std::uint64_t> allocationCount{0};
+
+    void* CountedAllocate(std::size_t size) noexcept {
+
+        ++allocationCount;
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    void* CountedAllocate(std::size_t size, std::align_val_t alignment) noexcept {
+
+        ++allocationCount;
+        auto align = static_cast<std::size_t>(alignment);
+        size       = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+        return std::aligned_alloc(align, size);
+    }
+
+    [[gnu::noinline]] void Release(void* ptr) noexcept {
+
+        std::free(ptr);
+    }
+} // namespace
+
+void* operator new(std::size_t size) {
+
+    if (auto* ptr = CountedAllocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+
+    if (auto* ptr = CountedAllocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+
+    if (auto* ptr = CountedAllocate(size, alignment)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+
+    if (auto* ptr = CountedAllocate(size, alignment)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAllocate(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAllocate(size, alignment); }
+
+void operator delete(void* ptr) noexcept { Release(ptr); }
+void operator delete[](void* ptr) noexcept { Release(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { Release(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { Release(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { Release(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { Release(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { Release(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { Release(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { Release(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { Release(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { Release(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { Release(ptr); }
+
+namespace
+{
+    /**
+     * @brief A sink that discards everything written to it.
+     */
+    class NullSink : public trl::Sink {
+    public:
+        void Write(const char*, std::size_t) override {}
+        void Flush() override {}
+    };
+
+    /**
+     * @brief A record, for the PrintRows case.
+     */
+    struct Record {
+        std::string name;
+        long long   count;
+        double      value;
+    };
+
+    /**
+     * @brief Print rows in two rounds, and report the allocations made by the second.
+     * @param name The name of the case.
+     * @param printRow Prints the row with the given index.
+     * @return true if the second round allocated nothing.
+     */
+    bool Check(const char* name, const std::function<void(std::size_t)>& printRow) {
+
+        constexpr std::size_t warmUpRows = 1000;
+        constexpr std::size_t rows       = 10000;
+
+        for (std::size_t row = 0; row < warmUpRows; ++row) printRow(row);
+
+        auto before = allocationCount.load();
+        for (std::size_t row = 0; row < rows; ++row) printRow(warmUpRows + row);
+        auto allocations = allocationCount.load() - before;
+
+        std::printf("%-34s %llu allocations in %zu rows\n", name, static_cast<unsigned long long>(allocations), rows);
+        return allocations == 0;
+    }
+} // namespace
+
+int main() {
+
+    NullSink sink;
+
+    std::vector<std::string> names;
+    std::vector<Record>      records;
+    std::vector<long long>   counts;
+    std::vector<double>      values;
+    for (std::size_t i = 0; i < 64; ++i) {
+        names.push_back("A name long enough to be cut, number " + std::to_string(i));
+        records.push_back({names.back(), static_cast<long long>(i * 7919) - 250000, static_cast<double>(i) / 7.0});
+        counts.push_back(records.back().count);
+        values.push_back(records.back().value);
+    }
+
+    auto ok = true;
+
+    trl::TablePrinter cells(sink);
+    cells.AddColumn("Name", 20);
+    cells.AddColumn("Count", 8);
+    cells.AddColumn("Value", 9);
+    cells.AddColumn("Label", 6);
+    cells.PrintHeader();
+    ok &= Check("operator<<", [&](std::size_t row) {
+        const auto& record = records[row % records.size()];
+        cells << record.name << record.count << record.value << std::string_view("label");
+    });
+
+    trl::TablePrinter formatted(sink);
+    formatted.AddColumn("Name", 20);
+    formatted.AddColumn("Count", 10, ",");
+    formatted.AddColumn("Value", 9, ".2e");
+    formatted.PrintHeader();
+    ok &= Check("operator<< (formatted)", [&](std::size_t row) {
+        const auto& record = records[row % records.size()];
+        formatted << record.name << record.count << record.value;
+    });
+
+    trl::TablePrinter csv(sink);
+    csv.SetOutputFormat(trl::OutputFormat::Csv);
+    csv.AddColumn("Name", 20);
+    csv.AddColumn("Count", 8);
+    csv.AddColumn("Value", 9);
+    csv.PrintHeader();
+    ok &= Check("operator<< (CSV)", [&](std::size_t row) {
+        const auto& record = records[row % records.size()];
+        csv << record.name << record.count << record.value;
+    });
+
+    trl::TablePrinter batch(sink);
+    batch.AddColumn("Name", 20);
+    batch.AddColumn("Count", 8);
+    batch.AddColumn("Value", 9);
+    batch.PrintHeader();
+    std::vector<Record> slice(records.begin(), records.begin() + 32);
+    ok &= Check("PrintRows", [&](std::size_t) {
+        batch.PrintRows(slice, &Record::name, &Record::count, &Record::value);
+    });
+
+    trl::TablePrinter columns(sink);
+    columns.AddColumn("Count", 8);
+    columns.AddColumn("Value", 9);
+    columns.PrintHeader();
+    ok &= Check("PrintColumns", [&](std::size_t) { columns.PrintColumns(counts, values); });
+
+    trl::StaticTablePrinter<trl::Column<std::string, 20>, trl::Column<long long, 8>, trl::Column<double, 9>> fixed(
+        {"Name", "Count", "Value"},
+        sink);
+    fixed.PrintHeader();
+    ok &= Check("StaticTablePrinter", [&](std::size_t row) {
+        const auto& record = records[row % records.size()];
+        fixed.PrintRow(record.name, record.count, record.value);
+    });
+    ok &= Check("StaticTablePrinter (long strings)", [&](std::size_t row) {
+        const auto& record = records[row % records.size()];
+        fixed.PrintRow(std::string_view(record.name), record.count, record.value);
+        fixed.PrintRow("A string literal well past the small string size", record.count, record.value);
+    });
+
+    if (!ok) {
+        std::printf("FAILED: rows allocated memory after warming up\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
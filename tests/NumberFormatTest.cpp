@@ -0,0 +1,99 @@
+//
+// Checks the number formats of columns: parsing of format specifications, thousands separators, SI and binary
+// suffixes (including a mantissa that rounds up to the next suffix) and the overflow marker.
+//
+// Each case formats a value with a format specification for a column width, and compares the text with the
+// expected text. The program fails if any case formats differently, or if a malformed specification is accepted.
+//
+
+#include <TablePrinter.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    /**
+     * @brief Format a value, and compare the text with the expected text.
+     * @param spec The format specification.
+     * @param value The value.
+     * @param width The column width.
+     * @param expected The expected text.
+     * @return true if the text is as expected.
+     */
+    template<typename T>
+    bool Check(const char* spec, T value, int width, std::string_view expected) {
+
+        trl::detail::NumberBuffer buffer;
+        auto                      text = trl::detail::NumberFormat(spec).Format(buffer, value, width);
+        auto                      ok   = text == expected;
+        std::printf("%-8s %-24s %s\n", spec, std::to_string(value).c_str(), ok ? "ok" : "FAILED");
+        if (!ok) std::printf("    expected \"%.*s\", got \"%.*s\"\n", int(expected.size()), expected.data(), int(text.size()), text.data());
+        return ok;
+    }
+
+    /**
+     * @brief Check that a malformed format specification is rejected.
+     * @param spec The format specification.
+     * @return true if the specification is rejected.
+     */
+    bool CheckRejected(const char* spec) {
+
+        auto ok = false;
+        try {
+            trl::detail::NumberFormat format(spec);
+        }
+        catch (const std::invalid_argument&) {
+            ok = true;
+        }
+        std::printf("%-8s %-24s %s\n", spec, "(rejected)", ok ? "ok" : "FAILED");
+        return ok;
+    }
+} // namespace
+
+int main() {
+
+    auto ok = true;
+
+    // Specification parsing
+    ok &= Check("", 1234567, 12, "1234567");
+    ok &= Check(".2f", 3.14159, 12, "3.14");
+    ok &= Check(">.3e", 12345.678, 12, "1.235e+04");
+    ok &= Check(".3g", 0.000123456, 12, "0.000123");
+    ok &= Check("<,", 1234567, 12, "1,234,567");
+    ok &= Check(".2f!#", 3.14159, 12, "3.14");
+    ok &= CheckRejected(".");
+    ok &= CheckRejected(".2x");
+    ok &= CheckRejected("!");
+    ok &= CheckRejected(".101f");
+    ok &= CheckRejected("f,");
+
+    // Thousands separators
+    ok &= Check(",", 999, 12, "999");
+    ok &= Check(",", -1234567, 12, "-1,234,567");
+    ok &= Check(",.2f", 1234567.891, 14, "1,234,567.89");
+    ok &= Check(",", 123456789012LL, 16, "123,456,789,012");
+
+    // SI and binary suffixes
+    ok &= Check("s", 999, 12, "999");
+    ok &= Check("s", 1500, 12, "1.5k");
+    ok &= Check(".2s", 2500000, 12, "2.50M");
+    ok &= Check("i", 1536, 12, "1.5Ki");
+    ok &= Check(".1s", 999999, 12, "1.0M");
+    ok &= Check(".1s", -999999, 12, "-1.0M");
+    ok &= Check(".1i", 1048575, 12, "1.0Mi");
+    ok &= Check(".1s", 999.96, 12, "1.0k");
+    ok &= Check(".1s", 999.94, 12, "999.9");
+    ok &= Check(".0s", 999.5, 12, "1k");
+
+    // The overflow marker
+    ok &= Check("", 123456789, 6, "12345*");
+    ok &= Check(".2f", 123456.789, 6, "12345*");
+    ok &= Check(".2f!>", 123456.789, 6, "12345>");
+    ok &= Check(",", 1234567, 6, "1,234*");
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
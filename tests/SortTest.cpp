@@ -0,0 +1,133 @@
+//
+// Checks the order in which sorted tables print their rows.
+//
+// Each case prints a small table in CSV format, sorted by a column that mixes numbers, text, blank text and NaN,
+// and compares the output with the expected order. The program fails if any case prints a different order, or
+// if a title or header is accepted after the rows of a sorted table.
+//
+
+#include <TablePrinter.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    /**
+     * @brief Print a table, and compare the output with the expected output.
+     * @param name The name of the case.
+     * @param setup Sets up the sorting of the printer.
+     * @param expected The expected output.
+     * @return true if the output is as expected.
+     */
+    bool Check(const char* name, const std::function<void(trl::TablePrinter&)>& setup, const std::string& expected) {
+
+        constexpr auto nan = std::numeric_limits<double>::quiet_NaN();
+
+        std::ostringstream output;
+        trl::TablePrinter  printer(output);
+        printer.SetOutputFormat(trl::OutputFormat::Csv);
+        printer.AddColumn("Name", 4);
+        printer.AddColumn("Value", 6);
+        setup(printer);
+
+        printer.PrintHeader();
+        printer << "a" << nan;
+        printer << "b" << "";
+        printer << "c" << 2;
+        printer << "d" << "text";
+        printer << "e" << 1;
+        printer << "f" << "";
+        printer << "g" << nan;
+        printer.PrintFooter();
+
+        auto ok = output.str() == expected;
+        std::printf("%-24s %s\n", name, ok ? "ok" : "FAILED");
+        if (!ok) std::printf("%s", output.str().c_str());
+        return ok;
+    }
+
+    /**
+     * @brief Check that a title or header printed after the rows of a sorted table is rejected, and that the table
+     * is printed as if it had not been.
+     * @param name The name of the case.
+     * @param setup Sets up the sorting of the printer.
+     * @param expected The expected output.
+     * @return true if both are rejected, and the output is as expected.
+     */
+    bool CheckLateHeader(const char* name, const std::function<void(trl::TablePrinter&)>& setup, const std::string& expected) {
+
+        std::ostringstream output;
+        trl::TablePrinter  printer(output);
+        printer.SetOutputFormat(trl::OutputFormat::Csv);
+        printer.AddColumn("Name", 4);
+        printer.AddColumn("Value", 6);
+        setup(printer);
+
+        printer.PrintHeader();
+        for (int row = 0; row < 20; ++row) printer << row << (row * 7) % 20;
+
+        auto rejected = 0;
+        try {
+            printer.PrintHeader();
+        }
+        catch (const std::logic_error&) {
+            ++rejected;
+        }
+        try {
+            printer.PrintTitle("Late");
+        }
+        catch (const std::logic_error&) {
+            ++rejected;
+        }
+        printer.PrintFooter();
+
+        auto ok = rejected == 2 && output.str() == expected;
+        std::printf("%-24s %s\n", name, ok ? "ok" : "FAILED");
+        if (!ok) std::printf("%d rejected\n%s", rejected, output.str().c_str());
+        return ok;
+    }
+} // namespace
+
+int main() {
+
+    auto ok = true;
+
+    ok &= Check(
+        "ascending",
+        [](trl::TablePrinter& printer) { printer.AddSortColumn(1); },
+        "Name,Value\ne,1\nc,2\nd,text\na,nan\nb,\nf,\ng,nan\n");
+
+    ok &= Check(
+        "descending",
+        [](trl::TablePrinter& printer) { printer.AddSortColumn(1, trl::SortOrder::Descending); },
+        "Name,Value\nc,2\ne,1\nd,text\na,nan\nb,\nf,\ng,nan\n");
+
+    ok &= Check(
+        "top rows",
+        [](trl::TablePrinter& printer) {
+            printer.AddSortColumn(1);
+            printer.SetTopRows(4);
+        },
+        "Name,Value\ne,1\nc,2\nd,text\na,nan\n");
+
+    ok &= CheckLateHeader(
+        "late header, top rows",
+        [](trl::TablePrinter& printer) { printer.SetTopRows(3); },
+        "Name,Value\n0,0\n1,7\n2,14\n");
+
+    ok &= CheckLateHeader(
+        "late header, sorted",
+        [](trl::TablePrinter& printer) {
+            printer.AddSortColumn(1, trl::SortOrder::Descending);
+            printer.SetTopRows(3);
+        },
+        "Name,Value\n17,19\n14,18\n11,17\n");
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}